@@ -0,0 +1,277 @@
+/**
+ * @file   libcrypt/include/cdc_chunker.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  content defined chunking with per chunk digests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_CDC_CHUNKER_HPP
+#define LIBCRYPT_CDC_CHUNKER_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "impl.hpp"
+#include "sha256.hpp"
+
+namespace crypt{
+    namespace impl{
+        // 256 pseudo random words from splitmix64, the Gear table of the rolling hash
+        constexpr std::array<std::uint64_t, 256> make_gear(){
+            std::array<std::uint64_t, 256> table{};
+            std::uint64_t x = 0;
+            for(std::size_t i = 0; i < table.size(); ++i){
+                x += 0x9e3779b97f4a7c15;
+                std::uint64_t z = x;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+                table[i] = z ^ (z >> 31);
+            }
+            return table;
+        }
+
+        inline constexpr std::array<std::uint64_t, 256> gear = make_gear();
+
+        // the n highest bits of the Gear hash, with every byte shifted one
+        // further up they depend on up to the last 64 bytes, n must be <= 64
+        constexpr std::uint64_t cdc_mask(unsigned n){
+            return n == 0 ? 0 : ~std::uint64_t{0} << (64 - n);
+        }
+
+        constexpr unsigned log2(std::size_t n){
+            unsigned bits = 0;
+            while(n >>= 1)
+                ++bits;
+            return bits;
+        }
+    }
+
+    /**
+     * Content defined chunking (FastCDC) with a digest per chunk.
+     *
+     * A Gear rolling hash picks chunk boundaries from the content, so an
+     * insertion only changes the chunks around it and the others still
+     * deduplicate. No boundary is taken before min_size bytes, a stricter
+     * mask is used up to avg_size and a looser one after it (normalized
+     * chunking), and a chunk is cut at max_size at the latest.
+     *
+     * Every piece of input is scanned for a boundary and then handed to
+     * Hash's bulk update right away, while it is still in cache, so
+     * chunking and hashing are a single pass. Chunks may span any number
+     * of update() calls, the boundaries do not depend on how the stream was
+     * split.
+     */
+    template<typename Hash = sha256>
+    class cdc_chunker{
+    public:
+        using digest_type = decltype(std::declval<Hash&>().final());
+        inline constexpr static std::size_t default_min_size = 2 * 1024;
+        inline constexpr static std::size_t default_avg_size = 8 * 1024;
+        inline constexpr static std::size_t default_max_size = 64 * 1024;
+
+        struct chunk{
+            std::uint64_t offset;         // in the whole stream
+            std::size_t size;
+            digest_type digest;
+        };
+
+        // throughput counters, time is spent inside update() and final()
+        struct stats{
+            std::uint64_t bytes = 0;
+            std::uint64_t chunks = 0;
+            std::uint64_t nanoseconds = 0;
+
+            double mb_per_s() const{
+                return nanoseconds == 0 ? 0.0 : static_cast<double>(bytes) * 1e3 / static_cast<double>(nanoseconds);
+            }
+        };
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        std::size_t min_size;
+        std::size_t avg_size;
+        std::size_t max_size;
+        std::uint64_t mask_s;             // before avg_size, harder to match
+        std::uint64_t mask_l;             // after avg_size, easier to match
+
+        Hash algo;
+        std::uint64_t fp = 0;
+        std::size_t size = 0;             // bytes of the current chunk
+        std::uint64_t offset = 0;         // start of the current chunk
+        stats counters;
+
+        /**
+         * The number of bytes at p that still belong to the current chunk,
+         * cut is set if the chunk ends after them.
+         */
+        std::size_t scan(const std::uint8_t* p, std::size_t len, bool& cut){
+            const std::size_t limit = std::min(len, max_size - size);
+            const std::size_t normal = std::min(limit, avg_size > size ? avg_size - size : 0);
+            std::size_t i = size < min_size ? std::min(limit, min_size - size) : 0;
+            std::uint64_t h = fp;
+
+            for(; i < normal; ++i){
+                h = (h << 1) + impl::gear[p[i]];
+                if(!(h & mask_s)){
+                    cut = true;
+                    return i + 1;
+                }
+            }
+            for(; i < limit; ++i){
+                h = (h << 1) + impl::gear[p[i]];
+                if(!(h & mask_l)){
+                    cut = true;
+                    return i + 1;
+                }
+            }
+            fp = h;
+            cut = size + limit == max_size;
+            return limit;
+        }
+
+        template<typename Emit>
+        void emit_chunk(Emit& emit){
+            const chunk c{offset, size, algo.final()};
+            algo.reset();
+            offset += size;
+            size = 0;
+            fp = 0;
+            ++counters.chunks;
+            emit(c);
+        }
+
+        template<typename Emit>
+        void update_contiguous(const std::uint8_t* p, std::size_t len, Emit& emit){
+            while(len != 0){
+                bool cut = false;
+                const std::size_t n = scan(p, len, cut);
+                algo.update(p, p + n);
+                size += n;
+                p += n;
+                len -= n;
+                if(cut)
+                    emit_chunk(emit);
+            }
+        }
+
+        void count(std::size_t bytes, clock::time_point start){
+            counters.bytes += bytes;
+            counters.nanoseconds += static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+        }
+
+    public:
+        explicit cdc_chunker(std::size_t min_chunk = default_min_size,
+                             std::size_t avg_chunk = default_avg_size,
+                             std::size_t max_chunk = default_max_size):
+            min_size{min_chunk},
+            avg_size{avg_chunk},
+            max_size{max_chunk}{
+            if(min_size == 0 || min_size > avg_size || avg_size > max_size)
+                throw std::invalid_argument("crypt::cdc_chunker: sizes must be 0 < min <= avg <= max");
+            // the strict mask takes two bits more than log2(avg_size)
+            const unsigned bits = impl::log2(avg_size);
+            if(bits > 61)
+                throw std::invalid_argument("crypt::cdc_chunker: avg_size must be below 2^62");
+            mask_s = impl::cdc_mask(bits + 2);
+            mask_l = impl::cdc_mask(bits > 2 ? bits - 2 : 0);
+        }
+
+        // drop the current chunk and the counters, start a new stream
+        void reset(){
+            algo.reset();
+            fp = 0;
+            size = 0;
+            offset = 0;
+            counters = stats{};
+        }
+
+        /**
+         * Chunk and hash [first, last), emit(const chunk&) is called for
+         * every chunk that ends in it.
+         */
+        template<typename Iterator, typename Emit>
+        void update(Iterator first, Iterator last, Emit&& emit){
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::cdc_chunker::update: T::value_type must be byte");
+            const auto start = clock::now();
+            std::size_t bytes = 0;
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(first != last){
+                    bytes = static_cast<std::size_t>(last - first);
+                    update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first), bytes, emit);
+                }
+            }else{
+                std::array<std::uint8_t, 4096> buffer;
+                while(first != last){
+                    std::size_t n = 0;
+                    for(; first != last && n < buffer.size(); ++first)
+                        buffer[n++] = static_cast<std::uint8_t>(*first);
+                    update_contiguous(buffer.data(), n, emit);
+                    bytes += n;
+                }
+            }
+            count(bytes, start);
+        }
+
+        // end of the stream, emits the last chunk unless it is empty
+        template<typename Emit>
+        void final(Emit&& emit){
+            const auto start = clock::now();
+            if(size != 0)
+                emit_chunk(emit);
+            count(0, start);
+        }
+
+        const stats& statistics() const{
+            return counters;
+        }
+
+        // all chunks of [first, last)
+        template<typename Iterator>
+        static std::vector<chunk> split(Iterator first, Iterator last,
+                                        std::size_t min_chunk = default_min_size,
+                                        std::size_t avg_chunk = default_avg_size,
+                                        std::size_t max_chunk = default_max_size){
+            std::vector<chunk> chunks;
+            auto emit = [&](const chunk& c){ chunks.push_back(c); };
+            cdc_chunker chunker{min_chunk, avg_chunk, max_chunk};
+            chunker.update(first, last, emit);
+            chunker.final(emit);
+            return chunks;
+        }
+    };
+}
+
+#endif /* LIBCRYPT_CDC_CHUNKER_HPP */
@@ -31,42 +31,161 @@
 #ifndef LIBCRYPT_DJB2_HPP
 #define LIBCRYPT_DJB2_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+
+#include "impl.hpp"
+#include "poly_simd.hpp"
+#include "thread_pool.hpp"
 
 namespace crypt{
-    class djb2{
-        std::uint32_t hash;
+    /**
+     * Bernstein's djb2, h = h * 33 + c mod 2^bits of Word. djb2 is the
+     * classic 32 bit hash, djb2_64 the same polynomial on 64 bit words
+     * for large hash tables.
+     */
+    template<typename Word>
+    class basic_djb2{
+        static_assert(std::is_same_v<Word, std::uint32_t> || std::is_same_v<Word, std::uint64_t>,
+                      "crypt::basic_djb2: Word must be std::uint32_t or std::uint64_t");
+
+    public:
+        typedef Word hash_type;
+        static constexpr Word default_seed = 5381;
+
+    private:
+        Word seed = default_seed;
+        Word state = default_seed;
 
     public:
-        djb2(){
+        constexpr basic_djb2(){
             reset();
         }
 
-        void reset(){
-            hash = 5381;
+        // start from initial instead of 5381, e.g. to derive independent hash functions
+        constexpr explicit basic_djb2(Word initial) : seed{initial}{
+            reset();
+        }
+
+        constexpr void reset(){
+            state = seed;
         }
 
         template<typename T>
-        void update(const T& byte){
+        constexpr void update(const T& byte){
             static_assert((sizeof(T) == 1),
                           "crypt::djb2::update: T must be byte");
-            hash = ((hash << 5) + hash) + byte; /* hash * 33 + c */
+            state = ((state << 5) + state) + byte; /* hash * 33 + c */
         }
 
         template<typename Iterator>
-        void update(Iterator first, Iterator last){
+        LIBCRYPT_FORCE_INLINE constexpr void update(Iterator first, Iterator last){
             static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
                           "crypt::djb::update: T::value_type must be byte");
+            // short keys stay in the inlined byte loop below
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(!impl::is_constant_evaluated() && last - first >= impl::poly_min_simd){
+                    using value_type = typename std::iterator_traits<Iterator>::value_type;
+                    state = impl::poly_update<Word, 33, std::is_signed_v<value_type>>::run(
+                        state, reinterpret_cast<const std::uint8_t*>(&*first),
+                        static_cast<std::size_t>(last - first));
+                    return;
+                }
+            }
             for(; first != last; ++first){
                 update(*first);
             }
         }
 
-        std::uint32_t final(){
-            return hash;
+        // update with large inputs split across the workers, same result as update(first, last)
+        template<typename Iterator>
+        void update(Iterator first, Iterator last, thread_pool& workers){
+            static_assert(impl::is_contiguous_iterator_v<Iterator>,
+                          "crypt::djb2::update: Iterator must be contiguous");
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::djb2::update: T::value_type must be byte");
+            if(first == last)
+                return;
+            using value_type = typename std::iterator_traits<Iterator>::value_type;
+            state = impl::poly_update<Word, 33, std::is_signed_v<value_type>>::run(
+                state, reinterpret_cast<const std::uint8_t*>(std::addressof(*first)),
+                static_cast<std::size_t>(last - first), workers);
+        }
+
+        constexpr Word final(){
+            return state;
         }
+
+        // name of the bulk kernel selected for this CPU and the current cap
+        static const char* kernel(){
+            return impl::poly_update<Word, 33, false>::kernel_name();
+        }
+
+        // hash of [first, last), usable in constant expressions
+        template<typename Iterator>
+        LIBCRYPT_FORCE_INLINE static constexpr Word hash(Iterator first, Iterator last){
+            basic_djb2 algo;
+            algo.update(first, last);
+            return algo.final();
+        }
+
+        LIBCRYPT_FORCE_INLINE static constexpr Word hash(std::string_view str){
+            return hash(str.begin(), str.end());
+        }
+
+        LIBCRYPT_FORCE_INLINE static constexpr Word hash(std::string_view str, Word initial){
+            basic_djb2 algo{initial};
+            algo.update(str.begin(), str.end());
+            return algo.final();
+        }
+
+        /**
+         * Hash every row of an offsets + bytes string column (Arrow layout),
+         * row i is [bytes + offsets[i], bytes + offsets[i + 1]) and hashes[i]
+         * is its hash from initial, the same as djb2::final() gives for it.
+         */
+        template<typename T, typename Offset>
+        static void hash_column(const T* bytes, const Offset* offsets, std::size_t rows,
+                                Word* hashes, Word initial = default_seed){
+            static_assert((sizeof(T) == 1),
+                          "crypt::djb2::hash_column: T must be byte");
+            static_assert(std::is_integral_v<Offset>,
+                          "crypt::djb2::hash_column: Offset must be integral");
+            impl::poly_column<Word, 33, std::is_signed_v<T>>::run(reinterpret_cast<const std::uint8_t*>(bytes),
+                                                              offsets, rows, hashes, initial);
+        }
+
+        /**
+         * The hash of a || b from left = hash(a), right = hash(b) and the
+         * length of b, both hashed from initial. Takes O(log right_length).
+         */
+        static constexpr Word combine(Word left, Word right, std::uint64_t right_length,
+                                      Word initial = default_seed){
+            return impl::poly_combine<Word, 33>(left, right, right_length, initial);
+        }
+
+        /**
+         * std::hash compatible functor for unordered containers. It is
+         * transparent, std::string, std::string_view and const char* keys
+         * all hash through a std::string_view without a temporary string.
+         */
+        struct hasher{
+            using is_transparent = void;
+
+            Word seed = default_seed;
+
+            LIBCRYPT_FORCE_INLINE constexpr std::size_t operator()(std::string_view str) const noexcept{
+                return static_cast<std::size_t>(hash(str, seed));
+            }
+        };
     };
+
+    using djb2 = basic_djb2<std::uint32_t>;
+    using djb2_64 = basic_djb2<std::uint64_t>;
 }
 
 #endif /* LIBCRYPT_DJB2_HPP */
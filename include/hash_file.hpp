@@ -0,0 +1,204 @@
+/**
+ * @file   libcrypt/include/hash_file.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  hash files through a memory mapping
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_HASH_FILE_HPP
+#define LIBCRYPT_HASH_FILE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+/* <unistd.h> declares crypt(3) which would clash with the namespace */
+#define crypt libcrypt_posix_crypt
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#undef crypt
+#define LIBCRYPT_POSIX_FILES
+#else
+#include <fstream>
+#endif
+
+#include "impl.hpp"
+
+namespace crypt{
+    namespace impl{
+        // size of one mapping window and of the read() buffer
+        inline constexpr std::size_t file_window = std::size_t{1} << 30;
+        inline constexpr std::size_t file_buffer = std::size_t{1} << 20;
+        inline constexpr std::size_t file_align  = 4096;
+
+        inline std::unique_ptr<std::uint8_t, aligned_free> file_buffer_alloc(){
+            void* p = std::aligned_alloc(file_align, file_buffer);
+            if(p == nullptr)
+                throw std::bad_alloc{};
+            return std::unique_ptr<std::uint8_t, aligned_free>{static_cast<std::uint8_t*>(p)};
+        }
+
+#if defined(LIBCRYPT_POSIX_FILES)
+        struct file_error{
+            [[noreturn]] static void raise(const char* what){
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+        };
+
+        template<typename Algo>
+        void update_read(Algo& algo, int fd){
+            auto buffer = file_buffer_alloc();
+            for(;;){
+                const ::ssize_t n = ::read(fd, buffer.get(), file_buffer);
+                if(n == 0)
+                    return;
+                if(n < 0){
+                    if(errno == EINTR)
+                        continue;
+                    file_error::raise("crypt::update_file: read");
+                }
+                algo.update(buffer.get(), buffer.get() + n);
+            }
+        }
+
+        /**
+         * Hash [offset, size) of a regular file through read only mappings of
+         * at most file_window bytes, false if the file can not be mapped.
+         */
+        template<typename Algo>
+        bool update_mmap(Algo& algo, int fd, std::uint64_t offset, std::uint64_t size){
+            const std::uint64_t page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+
+            while(offset < size){
+                const std::uint64_t base = offset / page * page;
+                const std::size_t skip = static_cast<std::size_t>(offset - base);
+                const std::size_t len = static_cast<std::size_t>(
+                    std::min<std::uint64_t>(size - base, file_window));
+
+                void* map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, static_cast<::off_t>(base));
+                if(map == MAP_FAILED)
+                    return false;
+                ::madvise(map, len, MADV_SEQUENTIAL);
+                ::madvise(map, len, MADV_WILLNEED);
+
+                const std::uint8_t* first = static_cast<const std::uint8_t*>(map);
+                algo.update(first + skip, first + len);
+                ::munmap(map, len);
+
+                offset = base + len;
+                // keep the descriptor in sync in case hashing fails later on
+                ::lseek(fd, static_cast<::off_t>(offset), SEEK_SET);
+            }
+            return true;
+        }
+#endif
+    }
+
+#if defined(LIBCRYPT_POSIX_FILES)
+    /**
+     * Feed everything from the current position of fd to its end into algo.
+     *
+     * Regular files are mapped into memory and hashed without copies, pipes,
+     * sockets and other special files are read() into a large aligned buffer.
+     * Anything past the size fstat() reported, as with procfs and sysfs files
+     * that report a size of 0 or a file that grows meanwhile, is read() too.
+     * The file must not be truncated while it is hashed.
+     */
+    template<typename Algo>
+    void update_file(Algo& algo, int fd){
+        struct ::stat st;
+        if(::fstat(fd, &st) != 0)
+            impl::file_error::raise("crypt::update_file: fstat");
+
+        if(S_ISREG(st.st_mode)){
+            const ::off_t offset = ::lseek(fd, 0, SEEK_CUR);
+            bool mapped = false;
+            if(offset >= 0 && offset <= st.st_size)
+                mapped = impl::update_mmap(algo, fd, static_cast<std::uint64_t>(offset),
+                                           static_cast<std::uint64_t>(st.st_size));
+#if defined(POSIX_FADV_SEQUENTIAL)
+            if(!mapped)
+                ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+        }
+        // goes on from where the mapping stopped, usually there is nothing left
+        impl::update_read(algo, fd);
+    }
+
+    // digest of everything from the current position of fd to its end
+    template<typename Algo>
+    auto hash_file(int fd){
+        Algo algo;
+        update_file(algo, fd);
+        return algo.final();
+    }
+
+    template<typename Algo>
+    auto hash_file(const std::string& path){
+        int fd;
+        do{
+            fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        }while(fd < 0 && errno == EINTR);
+        if(fd < 0)
+            impl::file_error::raise("crypt::hash_file: open");
+
+        struct closer{
+            int fd;
+            ~closer(){
+                ::close(fd);
+            }
+        } guard{fd};
+
+        return hash_file<Algo>(fd);
+    }
+#else
+    template<typename Algo>
+    auto hash_file(const std::string& path){
+        std::ifstream file{path, std::ios::binary};
+        if(!file)
+            throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory),
+                                    "crypt::hash_file: open");
+
+        Algo algo;
+        auto buffer = impl::file_buffer_alloc();
+        char* p = reinterpret_cast<char*>(buffer.get());
+        while(file.read(p, impl::file_buffer) || file.gcount() > 0)
+            algo.update(buffer.get(), buffer.get() + file.gcount());
+        return algo.final();
+    }
+#endif
+}
+
+#endif /* LIBCRYPT_HASH_FILE_HPP */
@@ -0,0 +1,139 @@
+/**
+ * @file   libcrypt/include/hash_many.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  digests of many independent messages on a thread pool
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_HASH_MANY_HPP
+#define LIBCRYPT_HASH_MANY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "impl.hpp"
+#include "md5.hpp"
+#include "md5_mb.hpp"
+#include "multibuffer.hpp"
+#include "sha224.hpp"
+#include "sha256.hpp"
+#include "sha256_mb.hpp"
+#include "thread_pool.hpp"
+
+namespace crypt{
+    namespace impl{
+        // messages below this size are grouped into one work item
+        inline constexpr std::size_t many_small = 4096;
+        // bytes of short messages per work item
+        inline constexpr std::size_t many_group = 64 * 1024;
+
+        // count short messages, on a multi-buffer kernel where Hash has one
+        template<typename Hash, typename Digest>
+        void hash_group(const std::uint8_t* const* messages, const std::size_t* lengths,
+                        std::size_t count, Digest* digests){
+            if constexpr(std::is_same_v<Hash, md5>){
+                if(md5_x16::accelerated())
+                    return md5_x16::hash(messages, lengths, count, digests);
+                if(md5_x8::accelerated())
+                    return md5_x8::hash(messages, lengths, count, digests);
+                if(md5_x4::accelerated())
+                    return md5_x4::hash(messages, lengths, count, digests);
+            }else if constexpr(std::is_same_v<Hash, sha256> || std::is_same_v<Hash, sha224>){
+                if(sha256_mb<Hash, 16>::accelerated())
+                    return sha256_mb<Hash, 16>::hash(messages, lengths, count, digests);
+                if(sha256_mb<Hash, 8>::accelerated())
+                    return sha256_mb<Hash, 8>::hash(messages, lengths, count, digests);
+            }
+            mb::run_serial<Hash>(messages, lengths, count, digests);
+        }
+    }
+
+    /**
+     * Hash count independent messages, message i is lengths[i] bytes at
+     * messages[i] and its digest is written to digests[i]. The digests are
+     * the same as hashing every message on its own with Hash.
+     *
+     * Neighbouring short messages are grouped into one work item, so they
+     * stay on one core and go through the multi-buffer kernels where the
+     * CPU has them (md5, sha224 and sha256). Every long message is an item
+     * of its own. The items are spread over the work stealing workers.
+     */
+    template<typename Hash>
+    void hash_many(const std::uint8_t* const* messages, const std::size_t* lengths, std::size_t count,
+                   decltype(std::declval<Hash&>().final())* digests,
+                   thread_pool& workers = thread_pool::global()){
+        // [first, first + n) of the messages
+        std::vector<std::pair<std::size_t, std::size_t>> items;
+        std::size_t group_bytes = 0;
+        for(std::size_t i = 0; i < count; ++i){
+            const bool small = lengths[i] < impl::many_small;
+            if(!small || items.empty() || group_bytes == 0 || group_bytes >= impl::many_group){
+                items.emplace_back(i, 1);
+                group_bytes = 0;
+            }else{
+                ++items.back().second;
+            }
+            if(small)
+                group_bytes += lengths[i] + 1;
+        }
+
+        workers.parallel_for(items.size(), [&](std::size_t item){
+            const std::size_t first = items[item].first;
+            const std::size_t n = items[item].second;
+            if(n == 1 && lengths[first] >= impl::many_small){
+                Hash algo;
+                algo.update(messages[first], messages[first] + lengths[first]);
+                digests[first] = algo.final();
+            }else{
+                impl::hash_group<Hash>(messages + first, lengths + first, n, digests + first);
+            }
+        });
+    }
+
+    // hash_many() over a range of contiguous byte containers
+    template<typename Hash, typename Messages>
+    std::vector<decltype(std::declval<Hash&>().final())> hash_many(const Messages& messages,
+                                                                  thread_pool& workers = thread_pool::global()){
+        std::vector<const std::uint8_t*> pointers;
+        std::vector<std::size_t> lengths;
+        for(const auto& message : messages){
+            static_assert((sizeof(*std::data(message)) == 1),
+                          "crypt::hash_many: Messages::value_type::value_type must be byte");
+            pointers.push_back(reinterpret_cast<const std::uint8_t*>(std::data(message)));
+            lengths.push_back(std::size(message));
+        }
+
+        std::vector<decltype(std::declval<Hash&>().final())> digests(pointers.size());
+        hash_many<Hash>(pointers.data(), lengths.data(), pointers.size(), digests.data(), workers);
+        return digests;
+    }
+}
+
+#endif /* LIBCRYPT_HASH_MANY_HPP */
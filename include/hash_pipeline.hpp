@@ -0,0 +1,323 @@
+/**
+ * @file   libcrypt/include/hash_pipeline.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  hashing on a dedicated thread fed through a ring of buffers
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_HASH_PIPELINE_HPP
+#define LIBCRYPT_HASH_PIPELINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "impl.hpp"
+
+namespace crypt{
+    namespace impl{
+        /**
+         * Lets one side of the ring sleep until the other one made progress.
+         * The ring indices stay lock free, the mutex is only touched once a
+         * side actually went to sleep.
+         */
+        class parking{
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::atomic<bool> waiting{false};
+
+        public:
+            template<typename Ready>
+            void wait(Ready ready){
+                for(int i = 0; i < 64; ++i){
+                    if(ready())
+                        return;
+                    std::this_thread::yield();
+                }
+                std::unique_lock<std::mutex> lock(mutex);
+                waiting.store(true);
+                cv.wait(lock, ready);
+                waiting.store(false);
+            }
+
+            // call after publishing the state wait() is looking for
+            void notify(){
+                if(waiting.load()){
+                    std::lock_guard<std::mutex> lock(mutex);
+                    cv.notify_one();
+                }
+            }
+        };
+    }
+
+    /**
+     * Hash a stream on a dedicated thread while the caller produces it.
+     *
+     * The producer fills buffers of a bounded single producer, single
+     * consumer ring and the hashing thread drains them through Hash's bulk
+     * update, so reading from a disk or socket overlaps the compression.
+     * Buffers are filled either in place through acquire()/commit(), by
+     * copying with update(), or not at all with submit(), which queues a
+     * view of memory the caller keeps alive until it was hashed.
+     *
+     * Once all depth slots are queued the producer blocks in acquire(),
+     * update() and submit(); try_acquire() and pending() expose that back
+     * pressure without blocking. finish() closes the stream, the digest is
+     * delivered through the future from get_future().
+     *
+     * All producer calls must come from one thread at a time.
+     */
+    template<typename Hash>
+    class hash_pipeline{
+    public:
+        using digest_type = decltype(std::declval<Hash&>().final());
+        inline constexpr static std::size_t default_depth = 8;
+        inline constexpr static std::size_t default_buffer_size = std::size_t{1} << 20;
+        inline constexpr static std::size_t buffer_align = 4096;
+
+    private:
+        struct slot{
+            const std::uint8_t* data;
+            std::size_t len;
+        };
+
+        const std::size_t depth;
+        const std::size_t size;
+        std::unique_ptr<std::uint8_t, impl::aligned_free> storage;
+        std::vector<slot> ring;
+
+        // producer and consumer positions on their own cache lines
+        alignas(64) std::atomic<std::size_t> head{0};
+        alignas(64) std::atomic<std::size_t> tail{0};
+        alignas(64) std::atomic<bool> closed{false};
+        impl::parking producer;
+        impl::parking consumer;
+
+        std::size_t filled = 0;           // bytes of update() in the head buffer
+        bool acquired = false;
+        std::promise<digest_type> promise;
+        std::thread worker;
+
+        // buffer_size rounded up to buffer_align, checked before anything
+        // is allocated for a ring of ring_depth buffers
+        static std::size_t round_size(std::size_t ring_depth, std::size_t buffer_size){
+            constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
+            if(ring_depth == 0 || buffer_size == 0)
+                throw std::invalid_argument("crypt::hash_pipeline: depth and buffer_size must not be 0");
+            if(buffer_size > max - (buffer_align - 1))
+                throw std::length_error("crypt::hash_pipeline: buffer_size too large");
+            const std::size_t rounded = (buffer_size + buffer_align - 1) / buffer_align * buffer_align;
+            if(ring_depth > max / rounded)
+                throw std::length_error("crypt::hash_pipeline: depth * buffer_size too large");
+            return rounded;
+        }
+
+        std::uint8_t* buffer(std::size_t index){
+            return storage.get() + (index % depth) * size;
+        }
+
+        void run(){
+            try{
+                Hash algo;
+                std::size_t t = tail.load(std::memory_order_relaxed);
+                for(;;){
+                    consumer.wait([&]{ return head.load() != t || closed.load(); });
+                    if(head.load() == t){
+                        promise.set_value(algo.final());
+                        return;
+                    }
+                    const slot& s = ring[t % depth];
+                    algo.update(s.data, s.data + s.len);
+                    tail.store(++t);
+                    producer.notify();
+                }
+            }catch(...){
+                promise.set_exception(std::current_exception());
+            }
+        }
+
+        void wait_free(){
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            producer.wait([&]{ return h - tail.load() < depth; });
+        }
+
+        void push(const std::uint8_t* data, std::size_t len){
+            const std::size_t h = head.load(std::memory_order_relaxed);
+            ring[h % depth] = slot{data, len};
+            head.store(h + 1);
+            consumer.notify();
+        }
+
+        void flush(){
+            if(filled != 0)
+                commit(filled);
+        }
+
+    public:
+        explicit hash_pipeline(std::size_t ring_depth = default_depth,
+                               std::size_t buffer_size = default_buffer_size):
+            depth{ring_depth},
+            size{round_size(ring_depth, buffer_size)},
+            ring(ring_depth){
+            void* p = std::aligned_alloc(buffer_align, depth * size);
+            if(p == nullptr)
+                throw std::bad_alloc{};
+            storage.reset(static_cast<std::uint8_t*>(p));
+            worker = std::thread{[this]{ run(); }};
+        }
+
+        hash_pipeline(const hash_pipeline&) = delete;
+        hash_pipeline& operator=(const hash_pipeline&) = delete;
+
+        // finishes the stream if that did not happen yet and joins the thread
+        ~hash_pipeline();
+
+        std::size_t buffer_size() const{
+            return size;
+        }
+
+        std::size_t capacity() const{
+            return depth;
+        }
+
+        // buffers queued and not hashed yet
+        std::size_t pending() const{
+            return head.load() - tail.load();
+        }
+
+        /**
+         * The head buffer of buffer_size() bytes to fill in place, blocks
+         * while every buffer is queued. Bytes of update() that are not
+         * committed yet are queued first.
+         */
+        std::uint8_t* acquire(){
+            flush();
+            wait_free();
+            acquired = true;
+            return buffer(head.load(std::memory_order_relaxed));
+        }
+
+        // like acquire(), but nullptr instead of blocking on a full ring
+        std::uint8_t* try_acquire(){
+            flush();
+            if(pending() == depth)
+                return nullptr;
+            acquired = true;
+            return buffer(head.load(std::memory_order_relaxed));
+        }
+
+        // queue the first len bytes of the acquired buffer for hashing
+        void commit(std::size_t len){
+            if(len > size)
+                throw std::length_error("crypt::hash_pipeline::commit: len exceeds buffer_size()");
+            filled = 0;
+            acquired = false;
+            push(buffer(head.load(std::memory_order_relaxed)), len);
+        }
+
+        /**
+         * Queue [data, data + len) without copying it. The memory has to
+         * stay valid until it was hashed, i.e. until pending() dropped
+         * below its value after this call or the digest is ready.
+         */
+        void submit(const std::uint8_t* data, std::size_t len){
+            flush();
+            wait_free();
+            push(data, len);
+        }
+
+        template<typename T>
+        void update(const T& byte){
+            static_assert((sizeof(T) == 1),
+                          "crypt::hash_pipeline::update: T must be byte");
+            const std::uint8_t b = static_cast<std::uint8_t>(byte);
+            update(&b, &b + 1);
+        }
+
+        // copy [first, last) into the ring
+        template<typename Iterator>
+        void update(Iterator first, Iterator last){
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::hash_pipeline::update: T::value_type must be byte");
+            while(first != last){
+                if(filled == 0 && !acquired){
+                    wait_free();
+                    acquired = true;
+                }
+                std::uint8_t* out = buffer(head.load(std::memory_order_relaxed)) + filled;
+                if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                    const std::size_t n = std::min(size - filled, static_cast<std::size_t>(last - first));
+                    std::memcpy(out, &*first, n);
+                    first += static_cast<typename std::iterator_traits<Iterator>::difference_type>(n);
+                    filled += n;
+                }else{
+                    for(; first != last && filled != size; ++first, ++out, ++filled)
+                        *out = static_cast<std::uint8_t>(*first);
+                }
+                if(filled == size)
+                    commit(filled);
+            }
+        }
+
+        // the digest of everything queued before finish(), call once
+        std::future<digest_type> get_future(){
+            return promise.get_future();
+        }
+
+        // queue what update() buffered and end the stream
+        void finish(){
+            if(closed.load())
+                return;
+            flush();
+            closed.store(true);
+            consumer.notify();
+        }
+    };
+
+    // defined out of class so it is not implicitly inline (-Winline on the cleanup paths)
+    template<typename Hash>
+    hash_pipeline<Hash>::~hash_pipeline(){
+        finish();
+        worker.join();
+    }
+}
+
+#endif /* LIBCRYPT_HASH_PIPELINE_HPP */
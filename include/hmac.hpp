@@ -0,0 +1,163 @@
+/**
+ * @file   libcrypt/include/hmac.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  keyed-hash message authentication code (RFC 2104)
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_HMAC_HPP
+#define LIBCRYPT_HMAC_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+
+#include "impl.hpp"
+
+namespace crypt{
+    /**
+     * HMAC over any block hasher with an exportable midstate (md5, sha1,
+     * sha224, sha256 and the sha512 family).
+     *
+     * The key is compressed into the inner (key ^ ipad) and outer
+     * (key ^ opad) chaining states once, when it is set. Every message then
+     * resumes from those, so a message that fits in one block costs two
+     * compressions instead of four, and reset() only copies a midstate.
+     */
+    template<typename Hash>
+    class hmac{
+    public:
+        using hash_type = Hash;
+        using digest_type = typename Hash::digest_type;
+        using midstate_type = typename Hash::midstate_type;
+        static constexpr std::size_t block_size = Hash::block_size;
+        static constexpr std::size_t digest_size = Hash::digest_size;
+
+    private:
+        midstate_type inner_pad{};
+        midstate_type outer_pad{};
+        Hash inner;
+
+        // compress one key block xor pad into a fresh midstate
+        LIBCRYPT_NOINLINE static constexpr midstate_type pad(const std::array<std::uint8_t, block_size>& key, std::uint8_t value){
+            std::array<std::uint8_t, block_size> block{};
+            for(std::size_t i = 0; i < block_size; ++i)
+                block[i] = static_cast<std::uint8_t>(key[i] ^ value);
+            midstate_type mid = Hash{}.export_midstate();
+            Hash::compress(mid, block.data(), 1);
+            return mid;
+        }
+
+    public:
+        // an empty key
+        constexpr hmac(){
+            rekey(static_cast<const std::uint8_t*>(nullptr), static_cast<const std::uint8_t*>(nullptr));
+        }
+
+        template<typename Iterator>
+        constexpr hmac(Iterator first, Iterator last){
+            rekey(first, last);
+        }
+
+        constexpr explicit hmac(std::string_view key){
+            rekey(key.begin(), key.end());
+        }
+
+        /**
+         * Set a new key and start a new message. Keys longer than a block
+         * are hashed first, as RFC 2104 requires. The key is read in one
+         * pass, so input iterators are fine.
+         */
+        template<typename Iterator>
+        LIBCRYPT_NOINLINE constexpr void rekey(Iterator first, Iterator last){
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::hmac::rekey: T::value_type must be byte");
+            std::array<std::uint8_t, block_size> key{};
+            std::size_t len = 0;
+            for(; first != last && len < block_size; ++first)
+                key[len++] = static_cast<std::uint8_t>(*first);
+
+            if(first != last){
+                Hash long_key;
+                long_key.update(key.begin(), key.end());
+                long_key.update(first, last);
+                const digest_type digest = long_key.final();
+                for(std::size_t i = 0; i < block_size; ++i)
+                    key[i] = i < digest.size() ? digest[i] : 0;
+            }
+
+            inner_pad = pad(key, 0x36);
+            outer_pad = pad(key, 0x5c);
+            reset();
+        }
+
+        // start a new message under the same key
+        constexpr void reset(){
+            inner.import_midstate(inner_pad);
+        }
+
+        template<typename T>
+        constexpr void update(const T& byte){
+            static_assert((sizeof(T) == 1),
+                          "crypt::hmac::update: T must be byte");
+            inner.update(byte);
+        }
+
+        template<typename Iterator>
+        constexpr void update(Iterator first, Iterator last){
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::hmac::update: T::value_type must be byte");
+            inner.update(first, last);
+        }
+
+        LIBCRYPT_NOINLINE constexpr digest_type final(){
+            const digest_type digest = inner.final();
+            Hash outer{outer_pad};
+            outer.update(digest.begin(), digest.end());
+            return outer.final();
+        }
+
+        // the keyed midstates, e.g. to share a key setup between threads
+        constexpr const midstate_type& inner_midstate() const{
+            return inner_pad;
+        }
+
+        constexpr const midstate_type& outer_midstate() const{
+            return outer_pad;
+        }
+
+        // mac of message under key, usable in constant expressions
+        LIBCRYPT_NOINLINE static constexpr digest_type mac(std::string_view key, std::string_view message){
+            hmac algo{key};
+            algo.update(message.begin(), message.end());
+            return algo.final();
+        }
+    };
+}
+
+#endif /* LIBCRYPT_HMAC_HPP */
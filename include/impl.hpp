@@ -32,59 +32,523 @@
 #ifndef LIBCRYPT_IMPL_HPP
 #define LIBCRYPT_IMPL_HPP
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#if !defined(LIBCRYPT_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define LIBCRYPT_X86_KERNELS
+#include <cpuid.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LIBCRYPT_FORCE_INLINE __attribute__((always_inline)) inline
+#define LIBCRYPT_NOINLINE __attribute__((noinline))
+#else
+#define LIBCRYPT_FORCE_INLINE inline
+#define LIBCRYPT_NOINLINE
+#endif
 
 namespace crypt{
     namespace impl{
         template<typename T>
-        constexpr T ROTLEFT(T a, std::size_t b){
+        inline constexpr bool is_char_v =
+            std::is_same_v<T, char> ||
+            std::is_same_v<T, signed char> ||
+            std::is_same_v<T, unsigned char>;
+
+        /**
+         * true if Iterator refers to elements laid out contiguously in memory,
+         * so a range [first, last) can be read through &*first directly.
+         */
+        template<typename Iterator>
+        struct is_contiguous_iterator{
+        private:
+            using value_type = std::remove_cv_t<typename std::iterator_traits<Iterator>::value_type>;
+            using string_type = std::conditional_t<is_char_v<value_type>,
+                                                   std::basic_string<value_type>,
+                                                   std::vector<value_type>>;
+            using string_view_type = std::conditional_t<is_char_v<value_type>,
+                                                        std::basic_string_view<value_type>,
+                                                        std::vector<value_type>>;
+
+        public:
+            static constexpr bool value =
+#if defined(__cpp_lib_concepts)
+                std::contiguous_iterator<Iterator> ||
+#endif
+                std::is_pointer_v<Iterator> ||
+                (!std::is_same_v<value_type, bool> &&
+                 (std::is_same_v<Iterator, typename std::vector<value_type>::iterator>       ||
+                  std::is_same_v<Iterator, typename std::vector<value_type>::const_iterator> ||
+                  std::is_same_v<Iterator, typename string_type::iterator>                   ||
+                  std::is_same_v<Iterator, typename string_type::const_iterator>             ||
+                  std::is_same_v<Iterator, typename string_view_type::const_iterator>));
+        };
+
+        template<typename Iterator>
+        inline constexpr bool is_contiguous_iterator_v = is_contiguous_iterator<Iterator>::value;
+
+        /**
+         * true while a constant expression is evaluated, used by the constexpr
+         * hashers to skip memcpy, reinterpret_cast and the SIMD kernels.
+         */
+        constexpr bool is_constant_evaluated() noexcept{
+#if defined(__cpp_lib_is_constant_evaluated)
+            return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__)
+            return __builtin_is_constant_evaluated();
+#else
+            return false;
+#endif
+        }
+
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr T ROTLEFT(T a, std::size_t b){
             static_assert(std::is_integral_v<T>, "type must be integral");
             return (a << b) | (a >> ((sizeof(T) * 8) - b));
         }
 
         template<typename T>
-        constexpr T ROTRIGHT(T a, std::size_t b){
+        LIBCRYPT_FORCE_INLINE constexpr T ROTRIGHT(T a, std::size_t b){
             static_assert(std::is_integral_v<T>, "type must be integral");
             return (a >> b) | (a << ((sizeof(T) * 8) - b));
         }
 
         template<typename T>
-        constexpr T CH(T x, T y, T z){
+        LIBCRYPT_FORCE_INLINE constexpr T CH(T x, T y, T z){
             static_assert(std::is_integral_v<T>, "type must be integral");
-            return (x & y) ^ (~x & z);
+            return z ^ (x & (y ^ z)); // (x & y) ^ (~x & z)
         }
 
         template<typename T>
-        constexpr T MAJ(T x, T y, T z){
+        LIBCRYPT_FORCE_INLINE constexpr T MAJ(T x, T y, T z){
             static_assert(std::is_integral_v<T>, "type must be integral");
-            return (x & y) ^ (x & z) ^ (y & z);
+            return y ^ ((x ^ y) & (y ^ z)); // (x & y) ^ (x & z) ^ (y & z)
         }
 
+        // SHA-2 functions, 64-bit words (sha512 family) use their own rotations
         template<typename T>
-        constexpr T EP0(T x){
+        LIBCRYPT_FORCE_INLINE constexpr T EP0(T x){
             static_assert(std::is_integral_v<T>, "type must be integral");
-            return ROTRIGHT(x, 2) ^ ROTRIGHT(x, 13) ^ ROTRIGHT(x, 22);
+            if constexpr(sizeof(T) == 8)
+                return ROTRIGHT(x, 28) ^ ROTRIGHT(x, 34) ^ ROTRIGHT(x, 39);
+            else
+                return ROTRIGHT(x, 2) ^ ROTRIGHT(x, 13) ^ ROTRIGHT(x, 22);
         }
 
         template<typename T>
-        constexpr T EP1(T x){
+        LIBCRYPT_FORCE_INLINE constexpr T EP1(T x){
             static_assert(std::is_integral_v<T>, "type must be integral");
-            return ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROTRIGHT(x, 25);
+            if constexpr(sizeof(T) == 8)
+                return ROTRIGHT(x, 14) ^ ROTRIGHT(x, 18) ^ ROTRIGHT(x, 41);
+            else
+                return ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROTRIGHT(x, 25);
         }
 
         template<typename T>
-        constexpr T SIG0(T x){
+        LIBCRYPT_FORCE_INLINE constexpr T SIG0(T x){
             static_assert(std::is_integral_v<T>, "type must be integral");
-            return ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ (x >> 3);
+            if constexpr(sizeof(T) == 8)
+                return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x >> 7);
+            else
+                return ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ (x >> 3);
         }
 
         template<typename T>
-        constexpr T SIG1(T x){
+        LIBCRYPT_FORCE_INLINE constexpr T SIG1(T x){
             static_assert(std::is_integral_v<T>, "type must be integral");
-            return ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ (x >> 10);
+            if constexpr(sizeof(T) == 8)
+                return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6);
+            else
+                return ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ (x >> 10);
+        }
+
+        /**
+         * Round I of SHA-2 on the working variables s with wk = W[I] + K[I].
+         * The variables are not moved, instead their roles rotate through s,
+         * so once the rounds are unrolled each one works on renamed registers.
+         */
+        template<std::size_t I, typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void sha2_round(T (&s)[8], T wk){
+            const T a = s[(8 - I % 8) % 8];
+            const T b = s[(9 - I % 8) % 8];
+            const T c = s[(10 - I % 8) % 8];
+            T& d      = s[(11 - I % 8) % 8];
+            const T e = s[(12 - I % 8) % 8];
+            const T f = s[(13 - I % 8) % 8];
+            const T g = s[(14 - I % 8) % 8];
+            T& h      = s[(15 - I % 8) % 8];
+
+            const T t1 = h + EP1(e) + CH(e, f, g) + wk;
+            const T t2 = EP0(a) + MAJ(a, b, c);
+            d += t1;
+            h = t1 + t2;
+        }
+
+        // round I with the message schedule kept in a ring of 16 words
+        template<std::size_t I, typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void sha2_round(T (&s)[8], T (&w)[16], const T* k){
+            if constexpr(I >= 16)
+                w[I % 16] += SIG1(w[(I - 2) % 16]) + w[(I - 7) % 16] + SIG0(w[(I - 15) % 16]);
+            sha2_round<I>(s, static_cast<T>(w[I % 16] + k[I]));
+        }
+
+        template<typename T, std::size_t... I>
+        LIBCRYPT_FORCE_INLINE constexpr void sha2_rounds(T (&s)[8], T (&w)[16], const T* k,
+                                                         std::index_sequence<I...>){
+            (sha2_round<I>(s, w, k), ...);
+        }
+
+        /**
+         * The same rounds as one loop, for policy::compact. The working
+         * variables are moved every round instead of renamed, which keeps the
+         * code to a single round body.
+         */
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void sha2_rounds_rolled(T (&s)[8], T (&w)[16], const T* k,
+                                                                std::size_t rounds){
+            for(std::size_t i = 0; i < rounds; ++i){
+                if(i >= 16)
+                    w[i % 16] += SIG1(w[(i - 2) % 16]) + w[(i - 7) % 16] + SIG0(w[(i - 15) % 16]);
+                const T t1 = s[7] + EP1(s[4]) + CH(s[4], s[5], s[6]) + w[i % 16] + k[i];
+                const T t2 = EP0(s[0]) + MAJ(s[0], s[1], s[2]);
+                s[7] = s[6];
+                s[6] = s[5];
+                s[5] = s[4];
+                s[4] = s[3] + t1;
+                s[3] = s[2];
+                s[2] = s[1];
+                s[1] = s[0];
+                s[0] = t1 + t2;
+            }
+        }
+
+        struct cpu_features{
+            bool sse2     = false;
+            bool ssse3    = false;
+            bool sse41    = false;
+            bool avx2     = false;
+            bool bmi2     = false;
+            bool sha      = false;
+            bool avx512f  = false;
+            bool avx512bw = false;
+        };
+    }
+
+    /**
+     * Compile time choice between speed and code size for the portable
+     * kernels, e.g. crypt::basic_sha256<crypt::policy::compact>. The plain
+     * names (crypt::sha256, ...) keep using policy::fast.
+     */
+    namespace policy{
+        // fully unrolled rounds plus every SIMD kernel, the default
+        struct fast{};
+        // rolled rounds and only the SHA-NI kernels, for size bound builds
+        struct compact{};
+    }
+
+    /**
+     * Instruction set levels, in the order the hashers prefer their
+     * kernels. set_max_isa() caps the kernels that may be selected at one
+     * of them, every level includes the ones before it.
+     */
+    enum class isa{
+        scalar,
+        sse2,
+        ssse3,
+        sse41,
+        avx2,
+        avx512,
+        sha_ni
+    };
+
+    namespace impl{
+        inline std::atomic<bool> scalar_forced{false};
+        // the cap set by set_max_isa(), -1 until then
+        inline std::atomic<int> isa_limit{-1};
+
+        struct cpu{
+            static cpu_features detect(){
+                cpu_features features;
+#if defined(LIBCRYPT_X86_KERNELS)
+                unsigned int eax, ebx, ecx, edx;
+                if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+                    return features;
+
+                features.sse2  = (edx & (1u << 26)) != 0;
+                features.ssse3 = (ecx & (1u <<  9)) != 0;
+                features.sse41 = (ecx & (1u << 19)) != 0;
+
+                // AVX state has to be enabled by the OS as well (OSXSAVE + XCR0)
+                std::uint64_t xcr0 = 0;
+                if(ecx & (1u << 27)){
+                    std::uint32_t lo, hi;
+                    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+                    xcr0 = (static_cast<std::uint64_t>(hi) << 32) | lo;
+                }
+                const bool os_avx    = (xcr0 & 0x06) == 0x06;
+                const bool os_avx512 = os_avx && (xcr0 & 0xe0) == 0xe0;
+
+                if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+                    return features;
+
+                features.avx2     = os_avx    && (ebx & (1u <<  5)) != 0;
+                features.bmi2     =              (ebx & (1u <<  8)) != 0;
+                features.sha      =              (ebx & (1u << 29)) != 0;
+                features.avx512f  = os_avx512 && (ebx & (1u << 16)) != 0;
+                features.avx512bw = os_avx512 && (ebx & (1u << 30)) != 0;
+#endif
+                return features;
+            }
+
+            // detected once, on first use
+            static const cpu_features& features(){
+                static const cpu_features detected = detect();
+                return detected;
+            }
+
+            // the level named by LIBCRYPT_MAX_ISA, no cap if it is unset or unknown
+            static isa environment_limit(){
+                static const isa limit = []{
+                    const char* name = std::getenv("LIBCRYPT_MAX_ISA");
+                    if(name == nullptr)
+                        return isa::sha_ni;
+                    const std::string_view value{name};
+                    constexpr std::pair<std::string_view, isa> names[] = {
+                        {"scalar", isa::scalar}, {"sse2", isa::sse2},     {"ssse3", isa::ssse3},
+                        {"sse4.1", isa::sse41},  {"sse41", isa::sse41},   {"avx2", isa::avx2},
+                        {"avx512", isa::avx512}, {"sha-ni", isa::sha_ni}, {"sha_ni", isa::sha_ni}
+                    };
+                    for(const auto& [key, level] : names)
+                        if(value == key)
+                            return level;
+                    return isa::sha_ni;
+                }();
+                return limit;
+            }
+
+            static isa limit(){
+                const int level = isa_limit.load(std::memory_order_relaxed);
+                return level < 0 ? environment_limit() : static_cast<isa>(level);
+            }
+
+            static bool allows(isa level){
+                return !scalar_forced.load(std::memory_order_relaxed) && level <= limit();
+            }
+
+            static bool scalar(){
+                return !allows(isa::sse2);
+            }
+
+            static bool sha_ni(){
+                return allows(isa::sha_ni) && features().sha && features().sse41;
+            }
+
+            static bool avx2_bmi2(){
+                return allows(isa::avx2) && features().avx2 && features().bmi2;
+            }
+
+            static bool sse2(){
+                return allows(isa::sse2) && features().sse2;
+            }
+
+            static bool ssse3(){
+                return allows(isa::ssse3) && features().ssse3;
+            }
+
+            static bool sse41(){
+                return allows(isa::sse41) && features().sse41;
+            }
+
+            static bool avx2(){
+                return allows(isa::avx2) && features().avx2;
+            }
+
+            static bool avx512f(){
+                return allows(isa::avx512) && features().avx512f;
+            }
+
+            // always true, for the portable fallback at the end of a kernel list
+            static bool portable(){
+                return true;
+            }
+        };
+
+        /**
+         * One implementation of a dispatched function: the name kernel()
+         * queries report, whether this CPU under the current cap can run it
+         * and its entry point.
+         */
+        template<typename Fn>
+        struct kernel{
+            const char* name;
+            bool (*usable)();
+            Fn* entry;
+        };
+
+        struct dispatch_slot{
+            std::atomic<const void*> bound{nullptr};
+            dispatch_slot* next = nullptr;
+            bool registered = false;
+        };
+
+        // every slot bound so far, unbound again when the cap changes
+        struct dispatch_registry{
+            static std::mutex& mutex(){
+                static std::mutex m;
+                return m;
+            }
+
+            static dispatch_slot*& slots(){
+                static dispatch_slot* head = nullptr;
+                return head;
+            }
+
+            static void add(dispatch_slot& slot){
+                std::lock_guard<std::mutex> lock(mutex());
+                if(slot.registered)
+                    return;
+                slot.registered = true;
+                slot.next = slots();
+                slots() = &slot;
+            }
+
+            static void unbind(){
+                std::lock_guard<std::mutex> lock(mutex());
+                for(dispatch_slot* slot = slots(); slot != nullptr; slot = slot->next)
+                    slot->bound.store(nullptr, std::memory_order_release);
+            }
+        };
+
+        /**
+         * A per-algorithm function pointer, like an ifunc resolver: bound on
+         * first use to the first usable kernel of a list ordered by
+         * preference, whose last entry is the portable fallback. The
+         * kernels carry their own target attributes, so the translation
+         * unit keeps its baseline ISA. A new cap unbinds every slot and the
+         * next call binds it again.
+         */
+        template<typename Fn>
+        class dispatch : dispatch_slot{
+            const kernel<Fn>* kernels;
+            std::size_t count;
+
+            LIBCRYPT_NOINLINE const void* bind(){
+                dispatch_registry::add(*this);
+                const kernel<Fn>* selected = kernels + count - 1;
+                for(std::size_t i = 0; i < count; ++i){
+                    if(kernels[i].usable()){
+                        selected = kernels + i;
+                        break;
+                    }
+                }
+                bound.store(selected, std::memory_order_release);
+                return selected;
+            }
+
+        public:
+            template<std::size_t N>
+            constexpr explicit dispatch(const kernel<Fn> (&list)[N]) : kernels{list}, count{N}{}
+
+            LIBCRYPT_FORCE_INLINE const kernel<Fn>& active(){
+                const void* selected = bound.load(std::memory_order_acquire);
+                return *static_cast<const kernel<Fn>*>(selected != nullptr ? selected : bind());
+            }
+        };
+    }
+
+    namespace impl{
+        // kept out of line, so the midstate accessors stay small enough to inline
+        struct midstate_error{
+            [[noreturn]] LIBCRYPT_NOINLINE static void unaligned(const char* what){
+                throw std::logic_error(what);
+            }
+
+            [[noreturn]] LIBCRYPT_NOINLINE static void invalid(const char* what){
+                throw std::invalid_argument(what);
+            }
+        };
+
+        // deleter for buffers from std::aligned_alloc
+        struct aligned_free{
+            void operator()(std::uint8_t* p) const{
+                std::free(p);
+            }
+        };
+
+        // the first len bytes of the digest of a chaining state
+        template<bool BigEndian, typename Word, std::size_t Words>
+        LIBCRYPT_FORCE_INLINE constexpr void store_digest(const std::array<Word, Words>& chain, std::uint8_t* out, std::size_t len){
+            for(std::size_t i = 0; i < len; ++i){
+                const std::size_t byte = BigEndian ? sizeof(Word) - 1 - i % sizeof(Word) : i % sizeof(Word);
+                out[i] = static_cast<std::uint8_t>(chain[i / sizeof(Word)] >> (byte * 8));
+            }
+        }
+    }
+
+    /**
+     * Chaining state of a block hasher together with the number of bits
+     * hashed so far, captured at a block boundary. Trivially copyable, so a
+     * shared prefix can be compressed once and the result stored, copied or
+     * sent anywhere and resumed with import_midstate().
+     */
+    template<typename Word, std::size_t Words>
+    struct midstate{
+        std::array<Word, Words> state;
+        std::uint64_t bitlen;
+
+        friend constexpr bool operator==(const midstate& lhs, const midstate& rhs){
+            if(lhs.bitlen != rhs.bitlen)
+                return false;
+            for(std::size_t i = 0; i < Words; ++i)
+                if(lhs.state[i] != rhs.state[i])
+                    return false;
+            return true;
         }
+
+        friend constexpr bool operator!=(const midstate& lhs, const midstate& rhs){
+            return !(lhs == rhs);
+        }
+    };
+
+    /**
+     * Restrict all hashers to their portable scalar kernels, regardless of
+     * what the CPU supports. Mainly useful to compare both paths in tests.
+     */
+    inline void force_scalar(bool enable){
+        impl::scalar_forced.store(enable, std::memory_order_relaxed);
+        impl::dispatch_registry::unbind();
+    }
+
+    /**
+     * Cap the kernels all hashers may select at level, e.g. to test the
+     * fallbacks on one machine. Without a call the cap is the level named
+     * by the LIBCRYPT_MAX_ISA environment variable (scalar, sse2, ssse3,
+     * sse4.1, avx2, avx512 or sha-ni), if any. Dispatched functions select
+     * their kernel again on their next call, so set it while no other
+     * thread is hashing.
+     */
+    inline void set_max_isa(isa level){
+        impl::isa_limit.store(static_cast<int>(level), std::memory_order_relaxed);
+        impl::dispatch_registry::unbind();
+    }
+
+    // the current cap, isa::sha_ni if there is none
+    inline isa max_isa(){
+        return impl::cpu::limit();
     }
 }
 
@@ -0,0 +1,500 @@
+/**
+ * @file   libcrypt/include/instrument.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  opt-in counters, sampled cycles and histograms for the block hashers
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_INSTRUMENT_HPP
+#define LIBCRYPT_INSTRUMENT_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "impl.hpp"
+
+/*
+ * Define LIBCRYPT_INSTRUMENT before the first libcrypt include to count
+ * bytes, update() calls, blocks, final() calls and partial block flushes per
+ * algorithm and to time a sample of the range update(), final() and
+ * transform() calls. Define
+ * LIBCRYPT_USDT as well or instead to fire USDT probes (provider libcrypt)
+ * at the same points for perf and bpftrace. Without either every hook is an
+ * empty constexpr function and the hashers compile as before.
+ */
+#if defined(LIBCRYPT_USDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define LIBCRYPT_USDT_PROBES
+#endif
+#endif
+
+#if defined(LIBCRYPT_INSTRUMENT) && defined(LIBCRYPT_X86_KERNELS)
+#include <x86intrin.h>
+#endif
+
+namespace crypt{
+    namespace instrument{
+#if defined(LIBCRYPT_INSTRUMENT)
+        inline constexpr bool enabled = true;
+#else
+        inline constexpr bool enabled = false;
+#endif
+
+        enum class algorithm{
+            md5,
+            sha1,
+            sha224,
+            sha256,
+            sha384,
+            sha512,
+            sha512_224,
+            sha512_256
+        };
+
+        inline constexpr std::size_t algorithm_count = 8;
+
+        constexpr const char* name(algorithm a){
+            switch(a){
+            case algorithm::md5:        return "md5";
+            case algorithm::sha1:       return "sha1";
+            case algorithm::sha224:     return "sha224";
+            case algorithm::sha256:     return "sha256";
+            case algorithm::sha384:     return "sha384";
+            case algorithm::sha512:     return "sha512";
+            case algorithm::sha512_224: return "sha512_224";
+            case algorithm::sha512_256: return "sha512_256";
+            default:                    return "unknown";
+            }
+        }
+
+        /**
+         * Log-scale histogram: bucket 0 counts zeros, bucket i the values in
+         * [2^(i-1), 2^i).
+         */
+        struct histogram{
+            static constexpr std::size_t size = 65;
+            std::array<std::uint64_t, size> buckets{};
+
+            static constexpr std::size_t bucket(std::uint64_t value){
+#if defined(__GNUC__) || defined(__clang__)
+                return value == 0 ? 0 : 64 - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+                std::size_t i = 0;
+                for(; value != 0; value >>= 1)
+                    i++;
+                return i;
+#endif
+            }
+
+            // the largest value bucket i can hold
+            static constexpr std::uint64_t upper_bound(std::size_t i){
+                return i >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << i) - 1;
+            }
+
+            constexpr std::uint64_t count() const{
+                std::uint64_t n = 0;
+                for(std::uint64_t b : buckets)
+                    n += b;
+                return n;
+            }
+        };
+
+        struct counters{
+            std::uint64_t bytes = 0;              // passed to update()
+            std::uint64_t updates = 0;            // update() calls with at least one byte
+            std::uint64_t blocks = 0;             // compressed, including the padding blocks
+            std::uint64_t finals = 0;             // final() calls
+            std::uint64_t flushes = 0;            // partial blocks completed and compressed from the buffer
+            std::uint64_t sampled_transforms = 0; // transform() calls that were timed
+            std::uint64_t sampled_blocks = 0;     // blocks in those calls
+            std::uint64_t sampled_cycles = 0;     // time stamp counter ticks spent in them
+            histogram update_bytes;               // size of each of those calls
+            histogram update_cycles;              // ticks of every timed update() call over a range
+            histogram final_cycles;               // ticks of every timed final() call
+            histogram transform_cycles;           // ticks of every timed transform() call
+        };
+
+        /**
+         * The totals of all threads at one point in time. Counters only
+         * grow, the activity between two snapshots is later.since(earlier).
+         */
+        struct snapshot{
+            std::array<counters, algorithm_count> algorithms{};
+
+            const counters& operator[](algorithm a) const{
+                return algorithms[static_cast<std::size_t>(a)];
+            }
+
+            snapshot since(const snapshot& earlier) const{
+                snapshot delta = *this;
+                for(std::size_t i = 0; i < algorithm_count; i++){
+                    counters& d = delta.algorithms[i];
+                    const counters& e = earlier.algorithms[i];
+                    d.bytes -= e.bytes;
+                    d.updates -= e.updates;
+                    d.blocks -= e.blocks;
+                    d.finals -= e.finals;
+                    d.flushes -= e.flushes;
+                    d.sampled_transforms -= e.sampled_transforms;
+                    d.sampled_blocks -= e.sampled_blocks;
+                    d.sampled_cycles -= e.sampled_cycles;
+                    for(std::size_t j = 0; j < histogram::size; j++){
+                        d.update_bytes.buckets[j] -= e.update_bytes.buckets[j];
+                        d.update_cycles.buckets[j] -= e.update_cycles.buckets[j];
+                        d.final_cycles.buckets[j] -= e.final_cycles.buckets[j];
+                        d.transform_cycles.buckets[j] -= e.transform_cycles.buckets[j];
+                    }
+                }
+                return delta;
+            }
+        };
+    }
+
+    namespace impl{
+#if defined(LIBCRYPT_INSTRUMENT)
+        // the counters of one algorithm in one thread, only that thread writes them
+        struct instrument_slot{
+            std::atomic<std::uint64_t> bytes;
+            std::atomic<std::uint64_t> updates;
+            std::atomic<std::uint64_t> blocks;
+            std::atomic<std::uint64_t> finals;
+            std::atomic<std::uint64_t> flushes;
+            std::atomic<std::uint64_t> sampled_transforms;
+            std::atomic<std::uint64_t> sampled_blocks;
+            std::atomic<std::uint64_t> sampled_cycles;
+            std::array<std::atomic<std::uint64_t>, instrument::histogram::size> update_bytes;
+            std::array<std::atomic<std::uint64_t>, instrument::histogram::size> update_cycles;
+            std::array<std::atomic<std::uint64_t>, instrument::histogram::size> final_cycles;
+            std::array<std::atomic<std::uint64_t>, instrument::histogram::size> transform_cycles;
+        };
+
+        /**
+         * The counters of one thread, linked into a list that is only ever
+         * pushed to. A thread that exits hands its block to the next new
+         * thread, so the totals carry on and the list stays as long as the
+         * most threads that hashed at once.
+         */
+        struct instrument_thread{
+            std::array<instrument_slot, instrument::algorithm_count> slots;
+            std::atomic<bool> in_use;
+            std::uint32_t countdown;    // sampled calls until the next timed one
+            instrument_thread* next;
+        };
+
+        inline std::atomic<instrument_thread*> instrument_threads{nullptr};
+        inline std::atomic<std::uint32_t> instrument_period{64};
+        inline thread_local instrument_thread* instrument_current = nullptr;
+        // set once this thread handed its block back, hashing in a later
+        // thread_local destructor is not counted instead of claiming a block
+        inline thread_local bool instrument_exited = false;
+
+        // single writer, so a plain load and store instead of a locked add
+        LIBCRYPT_FORCE_INLINE void instrument_add(std::atomic<std::uint64_t>& counter, std::uint64_t n){
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        /**
+         * Reload the countdown from the period, true if sampling is on.
+         * With the period at 0 it stays at 1, so every sampled call rereads
+         * the period and a later set_sample_period() takes effect at once.
+         */
+        LIBCRYPT_FORCE_INLINE bool instrument_rearm(instrument_thread& t){
+            const std::uint32_t period = instrument_period.load(std::memory_order_relaxed);
+            t.countdown = period != 0 ? period : 1;
+            return period != 0;
+        }
+
+        // one more sampled call, true if this one is timed
+        LIBCRYPT_FORCE_INLINE bool instrument_sample(instrument_thread& t){
+            return --t.countdown == 0 && instrument_rearm(t);
+        }
+
+        struct instrument_release{
+            instrument_thread* owned;
+
+            ~instrument_release(){
+                instrument_exited = true;
+                instrument_current = nullptr;
+                owned->in_use.store(false, std::memory_order_release);
+            }
+        };
+
+        // nullptr once the thread is exiting
+        LIBCRYPT_NOINLINE inline instrument_thread* instrument_acquire(){
+            if(instrument_exited)
+                return nullptr;
+            instrument_thread* t = instrument_threads.load(std::memory_order_acquire);
+            for(; t != nullptr; t = t->next){
+                bool idle = false;
+                if(!t->in_use.load(std::memory_order_relaxed) &&
+                   t->in_use.compare_exchange_strong(idle, true, std::memory_order_acquire))
+                    break;
+            }
+            if(t == nullptr){
+                t = new instrument_thread{};
+                t->in_use.store(true, std::memory_order_relaxed);
+                t->next = instrument_threads.load(std::memory_order_relaxed);
+                while(!instrument_threads.compare_exchange_weak(t->next, t, std::memory_order_release,
+                                                                std::memory_order_relaxed)){}
+            }
+            instrument_rearm(*t);
+            // hands the block back when this thread exits
+            static thread_local instrument_release release{t};
+            instrument_current = t;
+            return t;
+        }
+
+        LIBCRYPT_FORCE_INLINE instrument_thread* instrument_this_thread(){
+            instrument_thread* t = instrument_current;
+            return t != nullptr ? t : instrument_acquire();
+        }
+
+        LIBCRYPT_FORCE_INLINE instrument_slot* instrument_slot_of(instrument::algorithm a){
+            instrument_thread* t = instrument_this_thread();
+            return t != nullptr ? &t->slots[static_cast<std::size_t>(a)] : nullptr;
+        }
+
+        inline std::uint64_t instrument_ticks(){
+#if defined(LIBCRYPT_X86_KERNELS)
+            return __rdtsc();
+#else
+            return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+        }
+
+        // kept out of line, update() is inlined into every caller
+        LIBCRYPT_NOINLINE inline std::uint64_t instrument_begin(){
+            instrument_thread* t = instrument_this_thread();
+            return t != nullptr && instrument_sample(*t) ? instrument_ticks() : 0;
+        }
+
+        LIBCRYPT_NOINLINE inline void instrument_update(instrument::algorithm a, std::size_t bytes, std::uint64_t start){
+            instrument_slot* s = instrument_slot_of(a);
+            if(s == nullptr)
+                return;
+            instrument_add(s->bytes, bytes);
+            instrument_add(s->updates, 1);
+            instrument_add(s->update_bytes[instrument::histogram::bucket(bytes)], 1);
+            if(start != 0)
+                instrument_add(s->update_cycles[instrument::histogram::bucket(instrument_ticks() - start)], 1);
+        }
+#endif
+
+#if defined(LIBCRYPT_USDT_PROBES)
+        // out of the constexpr hooks, an asm statement may not appear in them
+        struct usdt{
+            LIBCRYPT_FORCE_INLINE static void update(instrument::algorithm a, std::size_t bytes){
+                DTRACE_PROBE2(libcrypt, update, static_cast<int>(a), bytes);
+            }
+
+            LIBCRYPT_FORCE_INLINE static void flush(instrument::algorithm a){
+                DTRACE_PROBE1(libcrypt, flush, static_cast<int>(a));
+            }
+
+            LIBCRYPT_FORCE_INLINE static void final(instrument::algorithm a){
+                DTRACE_PROBE1(libcrypt, final, static_cast<int>(a));
+            }
+
+            LIBCRYPT_FORCE_INLINE static void transform(instrument::algorithm a, std::size_t blocks){
+                DTRACE_PROBE2(libcrypt, transform, static_cast<int>(a), blocks);
+            }
+
+            LIBCRYPT_FORCE_INLINE static void transform_cycles(instrument::algorithm a, std::size_t blocks,
+                                                               std::uint64_t cycles){
+                DTRACE_PROBE3(libcrypt, transform_cycles, static_cast<int>(a), blocks, cycles);
+            }
+        };
+#endif
+
+        /**
+         * The hooks the hashers call. Each one is a no-op in constant
+         * expressions and compiles away unless LIBCRYPT_INSTRUMENT or
+         * LIBCRYPT_USDT is defined.
+         */
+        struct probe{
+            // the start tick of an update() or final() call if it is timed and 0 if not
+            LIBCRYPT_FORCE_INLINE static constexpr std::uint64_t call_begin(){
+                if(is_constant_evaluated())
+                    return 0;
+#if defined(LIBCRYPT_INSTRUMENT)
+                return instrument_begin();
+#else
+                return 0;
+#endif
+            }
+
+            // empty updates are not counted, start is from call_begin() or 0
+            LIBCRYPT_FORCE_INLINE static constexpr void update(instrument::algorithm a, std::size_t bytes,
+                                                               std::uint64_t start = 0){
+                if(is_constant_evaluated() || bytes == 0)
+                    return;
+#if defined(LIBCRYPT_INSTRUMENT)
+                instrument_update(a, bytes, start);
+#endif
+#if defined(LIBCRYPT_USDT_PROBES)
+                usdt::update(a, bytes);
+#endif
+                (void)a;
+                (void)bytes;
+                (void)start;
+            }
+
+            LIBCRYPT_FORCE_INLINE static constexpr void flush(instrument::algorithm a){
+                if(is_constant_evaluated())
+                    return;
+#if defined(LIBCRYPT_INSTRUMENT)
+                if(instrument_slot* s = instrument_slot_of(a))
+                    instrument_add(s->flushes, 1);
+#endif
+#if defined(LIBCRYPT_USDT_PROBES)
+                usdt::flush(a);
+#endif
+                (void)a;
+            }
+
+            LIBCRYPT_FORCE_INLINE static constexpr void final(instrument::algorithm a, std::uint64_t start){
+                if(is_constant_evaluated())
+                    return;
+#if defined(LIBCRYPT_INSTRUMENT)
+                if(instrument_slot* s = instrument_slot_of(a)){
+                    instrument_add(s->finals, 1);
+                    if(start != 0)
+                        instrument_add(s->final_cycles[instrument::histogram::bucket(instrument_ticks() - start)], 1);
+                }
+#endif
+#if defined(LIBCRYPT_USDT_PROBES)
+                usdt::final(a);
+#endif
+                (void)a;
+                (void)start;
+            }
+
+            // counts the blocks, returns the start tick if this call is timed and 0 if not
+            LIBCRYPT_FORCE_INLINE static constexpr std::uint64_t transform_begin(instrument::algorithm a, std::size_t blocks){
+                if(is_constant_evaluated())
+                    return 0;
+#if defined(LIBCRYPT_USDT_PROBES)
+                usdt::transform(a, blocks);
+#endif
+#if defined(LIBCRYPT_INSTRUMENT)
+                instrument_thread* t = instrument_this_thread();
+                if(t == nullptr)
+                    return 0;
+                instrument_add(t->slots[static_cast<std::size_t>(a)].blocks, blocks);
+                if(!instrument_sample(*t))
+                    return 0;
+                return instrument_ticks();
+#endif
+                (void)a;
+                (void)blocks;
+                return 0;
+            }
+
+            LIBCRYPT_FORCE_INLINE static constexpr void transform_end(instrument::algorithm a, std::size_t blocks,
+                                                                      std::uint64_t start){
+                if(is_constant_evaluated() || start == 0)
+                    return;
+#if defined(LIBCRYPT_INSTRUMENT)
+                const std::uint64_t cycles = instrument_ticks() - start;
+                instrument_slot& s = *instrument_slot_of(a);    // set, transform_begin() sampled
+                instrument_add(s.sampled_transforms, 1);
+                instrument_add(s.sampled_blocks, blocks);
+                instrument_add(s.sampled_cycles, cycles);
+                instrument_add(s.transform_cycles[instrument::histogram::bucket(cycles)], 1);
+#if defined(LIBCRYPT_USDT_PROBES)
+                usdt::transform_cycles(a, blocks, cycles);
+#endif
+#endif
+                (void)a;
+                (void)blocks;
+            }
+        };
+    }
+
+    namespace instrument{
+        /**
+         * Time one in period of the update() calls over a range, final()
+         * and transform() calls of each thread, counted together. 0 stops
+         * the timing, the counters are kept either way. Threads pick up a
+         * new period after their current countdown, or at their next such
+         * call while the timing is stopped.
+         */
+        inline void set_sample_period(std::uint32_t period){
+#if defined(LIBCRYPT_INSTRUMENT)
+            impl::instrument_period.store(period, std::memory_order_relaxed);
+#endif
+            (void)period;
+        }
+
+        inline std::uint32_t sample_period(){
+#if defined(LIBCRYPT_INSTRUMENT)
+            return impl::instrument_period.load(std::memory_order_relaxed);
+#else
+            return 0;
+#endif
+        }
+
+        /**
+         * Sum the counters of every thread without stopping them. Each
+         * counter is read atomically, but a snapshot taken while other
+         * threads hash may see one counter updated and the next not yet.
+         * All zero unless LIBCRYPT_INSTRUMENT is defined.
+         */
+        LIBCRYPT_NOINLINE inline snapshot collect(){
+            snapshot total;
+#if defined(LIBCRYPT_INSTRUMENT)
+            auto* t = impl::instrument_threads.load(std::memory_order_acquire);
+            for(; t != nullptr; t = t->next){
+                for(std::size_t i = 0; i < algorithm_count; i++){
+                    const impl::instrument_slot& s = t->slots[i];
+                    counters& c = total.algorithms[i];
+                    c.bytes += s.bytes.load(std::memory_order_relaxed);
+                    c.updates += s.updates.load(std::memory_order_relaxed);
+                    c.blocks += s.blocks.load(std::memory_order_relaxed);
+                    c.finals += s.finals.load(std::memory_order_relaxed);
+                    c.flushes += s.flushes.load(std::memory_order_relaxed);
+                    c.sampled_transforms += s.sampled_transforms.load(std::memory_order_relaxed);
+                    c.sampled_blocks += s.sampled_blocks.load(std::memory_order_relaxed);
+                    c.sampled_cycles += s.sampled_cycles.load(std::memory_order_relaxed);
+                    for(std::size_t j = 0; j < histogram::size; j++){
+                        c.update_bytes.buckets[j] += s.update_bytes[j].load(std::memory_order_relaxed);
+                        c.update_cycles.buckets[j] += s.update_cycles[j].load(std::memory_order_relaxed);
+                        c.final_cycles.buckets[j] += s.final_cycles[j].load(std::memory_order_relaxed);
+                        c.transform_cycles.buckets[j] += s.transform_cycles[j].load(std::memory_order_relaxed);
+                    }
+                }
+            }
+#endif
+            return total;
+        }
+    }
+}
+
+#endif /* LIBCRYPT_INSTRUMENT_HPP */
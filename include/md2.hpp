@@ -65,9 +65,9 @@ namespace crypt{
             49,  68,  80,  180, 143, 237, 31,  26,  219, 153, 141, 51,  159, 17,  131, 20
         };
 
-        void transform(){
+        void transform(const std::uint8_t* block){
             for(std::uint8_t j = 0; j < 16; ++j){
-                state[j + 16] = data[j];
+                state[j + 16] = block[j];
                 state[j + 32] = (state[j+16] ^ state[j]);
             }
 
@@ -82,11 +82,33 @@ namespace crypt{
 
             t = checksum[15];
             for(std::uint8_t j = 0; j < 16; ++j){
-                checksum[j] = static_cast<std::uint8_t>(checksum[j] ^ s[data[j] ^ t]);
+                checksum[j] = static_cast<std::uint8_t>(checksum[j] ^ s[block[j] ^ t]);
                 t = checksum[j];
             }
         }
 
+        // Fill the partially buffered block once, transform every full block
+        // straight from the input and buffer only the remaining tail.
+        void update_contiguous(const std::uint8_t* first, std::size_t n){
+            if(len != 0){
+                std::size_t fill = data.size() - len;
+                if(fill > n)
+                    fill = n;
+                std::memcpy(data.data() + len, first, fill);
+                len += static_cast<std::uint32_t>(fill);
+                first += fill;
+                n -= fill;
+                if(len != data.size())
+                    return;
+                transform(data.data());
+                len = 0;
+            }
+            for(; n >= data.size(); first += data.size(), n -= data.size())
+                transform(first);
+            std::memcpy(data.data(), first, n);
+            len = static_cast<std::uint32_t>(n);
+        }
+
     public:
         md2(){
             reset();
@@ -105,7 +127,7 @@ namespace crypt{
             data[len] = static_cast<std::uint8_t>(byte);
             len++;
             if(len == data.size()){
-                transform();
+                transform(data.data());
                 len = 0;
             }
         }
@@ -114,8 +136,14 @@ namespace crypt{
         void update(Iterator first, Iterator last){
             static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
                           "crypt::md2::update: T::value_type must be byte");
-            for(; first != last; ++first){
-                update(*first);
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(first != last)
+                    update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first),
+                                      static_cast<std::size_t>(last - first));
+            }else{
+                for(; first != last; ++first){
+                    update(*first);
+                }
             }
         }
 
@@ -125,7 +153,7 @@ namespace crypt{
             while(len < data.size())
                 data[len++] = to_pad;
 
-            transform();
+            transform(data.data());
 
             for(std::uint8_t j = 0; j < 16; ++j){
                 state[j + 16] = checksum[j];
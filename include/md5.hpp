@@ -34,63 +34,48 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <string_view>
+#include <type_traits>
 
 #include "impl.hpp"
+#include "instrument.hpp"
 
 namespace crypt{
     namespace impl{
-        constexpr void FF(std::uint32_t& a, std::uint32_t b, std::uint32_t c,
-                          std::uint32_t d, std::uint32_t m, std::uint32_t s, std::uint32_t t){
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void FF(T& a, const T& b, const T& c, const T& d, const T& m, std::uint32_t s, std::uint32_t t){
             a += ((b & c) | (~b & d)) + m + t;
-            a = b + ROTLEFT(a,s);
+            a = b + ((a << s) | (a >> (32 - s)));
         }
 
-        constexpr void GG(std::uint32_t& a, std::uint32_t b, std::uint32_t c,
-                          std::uint32_t d, std::uint32_t m, std::uint32_t s, std::uint32_t t){
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void GG(T& a, const T& b, const T& c, const T& d, const T& m, std::uint32_t s, std::uint32_t t){
             a += ((b & d) | (c & ~d)) + m + t;
-            a = b + ROTLEFT(a,s);
+            a = b + ((a << s) | (a >> (32 - s)));
         }
 
-        constexpr void HH(std::uint32_t& a, std::uint32_t b, std::uint32_t c,
-                          std::uint32_t d, std::uint32_t m, std::uint32_t s, std::uint32_t t){
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void HH(T& a, const T& b, const T& c, const T& d, const T& m, std::uint32_t s, std::uint32_t t){
             a += (b ^ c ^ d) + m + t;
-            a = b + ROTLEFT(a,s);
+            a = b + ((a << s) | (a >> (32 - s)));
         }
 
-        constexpr void II(std::uint32_t& a, std::uint32_t b, std::uint32_t c,
-                          std::uint32_t d, std::uint32_t m, std::uint32_t s, std::uint32_t t){
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void II(T& a, const T& b, const T& c, const T& d, const T& m, std::uint32_t s, std::uint32_t t){
             a += (c ^ (b | ~d)) + m + t;
-            a = b + ROTLEFT(a,s);
+            a = b + ((a << s) | (a >> (32 - s)));
         }
-    }
-
-    class md5{
-        std::array<std::uint8_t, 64> data;
-        std::uint32_t datalen;
-        std::uint64_t bitlen;
-        std::array<std::uint32_t, 4> state;
-
-        void transform(){
-            std::array<std::uint32_t, 16> m;
-            std::uint32_t a, b, c, d, i, j;
-
-            // MD5 specifies big endian byte order, but this implementation assumes a little
-            // endian byte order CPU. Reverse all the bytes upon input, and re-reverse them
-            // on output (in final()).
-            for(i = 0, j = 0; i < 16; ++i, j += 4)
-                m[i] = static_cast<std::uint32_t>((data[j]          ) +
-                                                  (data[j + 1] <<  8) +
-                                                  (data[j + 2] << 16) +
-                                                  (data[j + 3] << 24)   );
-
-            a = state[0];
-            b = state[1];
-            c = state[2];
-            d = state[3];
 
+        /**
+         * The 64 md5 rounds on a, b, c and d with the message words m. T is
+         * std::uint32_t for md5::transform() or a vector with one word per
+         * lane for the multi-buffer kernels.
+         */
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void md5_rounds(T& a, T& b, T& c, T& d, const T* m){
             {
-                using impl::FF;
                 FF(a,b,c,d,m[0],  7,0xd76aa478);
                 FF(d,a,b,c,m[1], 12,0xe8c7b756);
                 FF(c,d,a,b,m[2], 17,0x242070db);
@@ -110,7 +95,6 @@ namespace crypt{
             }
 
             {
-                using impl::GG;
                 GG(a,b,c,d,m[1],  5,0xf61e2562);
                 GG(d,a,b,c,m[6],  9,0xc040b340);
                 GG(c,d,a,b,m[11],14,0x265e5a51);
@@ -130,7 +114,6 @@ namespace crypt{
             }
 
             {
-                using impl::HH;
                 HH(a,b,c,d,m[5],  4,0xfffa3942);
                 HH(d,a,b,c,m[8], 11,0x8771f681);
                 HH(c,d,a,b,m[11],16,0x6d9d6122);
@@ -150,7 +133,6 @@ namespace crypt{
             }
 
             {
-                using impl::II;
                 II(a,b,c,d,m[0],  6,0xf4292244);
                 II(d,a,b,c,m[7], 10,0x432aff97);
                 II(c,d,a,b,m[14],15,0xab9423a7);
@@ -168,19 +150,151 @@ namespace crypt{
                 II(c,d,a,b,m[2], 15,0x2ad7d2bb);
                 II(b,c,d,a,m[9], 21,0xeb86d391);
             }
+        }
+
+        // the additive constants and rotations of md5_rounds() in round order
+        inline constexpr std::array<std::uint32_t, 64> md5_k{
+            0xd76aa478,0xe8c7b756,0x242070db,0xc1bdceee,0xf57c0faf,0x4787c62a,0xa8304613,0xfd469501,
+            0x698098d8,0x8b44f7af,0xffff5bb1,0x895cd7be,0x6b901122,0xfd987193,0xa679438e,0x49b40821,
+            0xf61e2562,0xc040b340,0x265e5a51,0xe9b6c7aa,0xd62f105d,0x02441453,0xd8a1e681,0xe7d3fbc8,
+            0x21e1cde6,0xc33707d6,0xf4d50d87,0x455a14ed,0xa9e3e905,0xfcefa3f8,0x676f02d9,0x8d2a4c8a,
+            0xfffa3942,0x8771f681,0x6d9d6122,0xfde5380c,0xa4beea44,0x4bdecfa9,0xf6bb4b60,0xbebfbc70,
+            0x289b7ec6,0xeaa127fa,0xd4ef3085,0x04881d05,0xd9d4d039,0xe6db99e5,0x1fa27cf8,0xc4ac5665,
+            0xf4292244,0x432aff97,0xab9423a7,0xfc93a039,0x655b59c3,0x8f0ccc92,0xffeff47d,0x85845dd1,
+            0x6fa87e4f,0xfe2ce6e0,0xa3014314,0x4e0811a1,0xf7537e82,0xbd3af235,0x2ad7d2bb,0xeb86d391
+        };
+
+        inline constexpr std::array<std::uint32_t, 16> md5_r{
+            7,12,17,22, 5, 9,14,20, 4,11,16,23, 6,10,15,21
+        };
+
+        // the same rounds as one loop for policy::compact, the variables are moved
+        LIBCRYPT_FORCE_INLINE constexpr void md5_rounds_rolled(std::uint32_t& a, std::uint32_t& b, std::uint32_t& c,
+                                                               std::uint32_t& d, const std::uint32_t* m){
+            for(std::uint32_t i = 0; i < 64; ++i){
+                std::uint32_t f = 0;
+                std::uint32_t g = 0;
+                if(i < 16){
+                    f = (b & c) | (~b & d);
+                    g = i;
+                }else if(i < 32){
+                    f = (b & d) | (c & ~d);
+                    g = (5 * i + 1) % 16;
+                }else if(i < 48){
+                    f = b ^ c ^ d;
+                    g = (3 * i + 5) % 16;
+                }else{
+                    f = c ^ (b | ~d);
+                    g = (7 * i) % 16;
+                }
+
+                const std::uint32_t r = md5_r[i / 16 * 4 + i % 4];
+                const std::uint32_t t = a + f + m[g] + md5_k[i];
+                a = d;
+                d = c;
+                c = b;
+                b += (t << r) | (t >> (32 - r));
+            }
+        }
+    }
+
+    template<typename Policy = policy::fast>
+    class basic_md5{
+        std::array<std::uint8_t, 64> data{};
+        std::uint32_t datalen = 0;
+        std::uint64_t bitlen = 0;
+        std::array<std::uint32_t, 4> state{};
+        static constexpr instrument::algorithm probe_id = instrument::algorithm::md5;
+
+        LIBCRYPT_NOINLINE static constexpr void transform(std::array<std::uint32_t, 4>& chain, const std::uint8_t* block){
+            // not const, a constant initializer would be folded with the hook skipped
+            std::uint64_t sample = impl::probe::transform_begin(probe_id, 1);
+            std::array<std::uint32_t, 16> m{};
+            std::uint32_t i = 0, j = 0;
+
+            // MD5 specifies big endian byte order, but this implementation assumes a little
+            // endian byte order CPU. Reverse all the bytes upon input, and re-reverse them
+            // on output (in final()).
+            for(; i < 16; ++i, j += 4)
+                m[i] = static_cast<std::uint32_t>((block[j]          ) +
+                                                  (block[j + 1] <<  8) +
+                                                  (block[j + 2] << 16) +
+                                                  (block[j + 3] << 24)   );
+
+            std::uint32_t a = chain[0];
+            std::uint32_t b = chain[1];
+            std::uint32_t c = chain[2];
+            std::uint32_t d = chain[3];
+
+            if constexpr(std::is_same_v<Policy, policy::compact>)
+                impl::md5_rounds_rolled(a, b, c, d, m.data());
+            else
+                impl::md5_rounds(a, b, c, d, m.data());
+
+            chain[0] += a;
+            chain[1] += b;
+            chain[2] += c;
+            chain[3] += d;
+            impl::probe::transform_end(probe_id, 1, sample);
+        }
+
+        // one byte into the buffer, compressed once the block is full
+        constexpr void append(std::uint8_t byte){
+            data[datalen] = byte;
+            datalen++;
+            if(datalen == data.size()){
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 512;
+                datalen = 0;
+            }
+        }
+
+        // Fill the partially buffered block once, transform every full block
+        // straight from the input and buffer only the remaining tail.
+        void absorb(const std::uint8_t* first, std::size_t len){
+            if(datalen != 0){
+                std::size_t fill = data.size() - datalen;
+                if(fill > len)
+                    fill = len;
+                std::memcpy(data.data() + datalen, first, fill);
+                datalen += static_cast<std::uint32_t>(fill);
+                first += fill;
+                len -= fill;
+                if(datalen != data.size())
+                    return;
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 512;
+                datalen = 0;
+            }
+            for(; len >= data.size(); first += data.size(), len -= data.size()){
+                transform(state, first);
+                bitlen += 512;
+            }
+            std::memcpy(data.data(), first, len);
+            datalen = static_cast<std::uint32_t>(len);
+        }
 
-            state[0] += a;
-            state[1] += b;
-            state[2] += c;
-            state[3] += d;
+        // update() over a contiguous range, counted and timed as one call
+        void update_contiguous(const std::uint8_t* first, std::size_t len){
+            std::uint64_t sample = impl::probe::call_begin();
+            absorb(first, len);
+            impl::probe::update(probe_id, len, sample);
         }
 
     public:
-        md5(){
+        using digest_type = std::array<std::uint8_t, 16>;
+        using midstate_type = crypt::midstate<std::uint32_t, 4>;
+        static constexpr std::size_t block_size = 64;
+        static constexpr std::size_t digest_size = 16;
+        static constexpr bool big_endian = false;    // byte order of the digest and length words
+
+        constexpr basic_md5(){
             reset();
         }
 
-        void reset(){
+        constexpr void reset(){
             datalen = 0;
             bitlen = 0;
             state[0] = 0x67452301;
@@ -189,30 +303,84 @@ namespace crypt{
             state[3] = 0x10325476;
         }
 
+        /**
+         * Resume from a chaining state exported at a block boundary, e.g. a
+         * shared prefix that was compressed once.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr explicit basic_md5(const midstate_type& mid){
+            import_midstate(mid);
+        }
+
+        // true if no partial block is buffered and the state can be exported
+        constexpr bool block_aligned() const{
+            return datalen == 0;
+        }
+
+        /**
+         * The chaining state and the number of bits hashed so far. Only
+         * defined at a block boundary, throws std::logic_error while a
+         * partial block is buffered.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr midstate_type export_midstate() const{
+            if(datalen != 0)
+                impl::midstate_error::unaligned("crypt::md5::export_midstate: not at a block boundary");
+            return midstate_type{state, bitlen};
+        }
+
+        LIBCRYPT_FORCE_INLINE constexpr void import_midstate(const midstate_type& mid){
+            if(mid.bitlen % 512 != 0)
+                impl::midstate_error::invalid("crypt::md5::import_midstate: not at a block boundary");
+            datalen = 0;
+            bitlen = mid.bitlen;
+            state = mid.state;
+        }
+
+        // an independent copy, including a buffered partial block
+        constexpr basic_md5 fork() const{
+            return *this;
+        }
+
+        /**
+         * Compress count whole blocks into mid, without buffering or
+         * padding. The building block for hashing many suffixes after one
+         * shared prefix.
+         */
+        static constexpr void compress(midstate_type& mid, const std::uint8_t* blocks, std::size_t count){
+            for(std::size_t i = 0; i < count; ++i)
+                transform(mid.state, blocks + i * block_size);
+            mid.bitlen += 512 * static_cast<std::uint64_t>(count);
+        }
+
         template<typename T>
-        void update(const T& byte){
+        LIBCRYPT_FORCE_INLINE constexpr void update(const T& byte){
             static_assert((sizeof(T) == 1),
                           "crypt::md5::update: T must be byte");
-            data[datalen] = static_cast<std::uint8_t>(byte);
-            datalen++;
-            if(datalen == data.size()){
-                transform();
-                bitlen += 512;
-                datalen = 0;
-            }
+            impl::probe::update(probe_id, 1);
+            append(static_cast<std::uint8_t>(byte));
         }
 
         template<typename Iterator>
-        void update(Iterator first, Iterator last){
+        constexpr void update(Iterator first, Iterator last){
             static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
                           "crypt::md5::update: T::value_type must be byte");
-            for(; first != last; ++first){
-                update(*first);
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(!impl::is_constant_evaluated()){
+                    if(first != last)
+                        update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first),
+                                          static_cast<std::size_t>(last - first));
+                    return;
+                }
             }
+            std::uint64_t sample = impl::probe::call_begin();
+            std::size_t count = 0;
+            for(; first != last; ++first, ++count)
+                append(static_cast<std::uint8_t>(*first));
+            impl::probe::update(probe_id, count, sample);
         }
 
-        std::array<std::uint8_t, 16> final(){
-            std::array<std::uint8_t, 16> hash;
+        LIBCRYPT_NOINLINE constexpr std::array<std::uint8_t, 16> final(){
+            std::uint64_t sample = impl::probe::call_begin();
+            std::array<std::uint8_t, 16> hash{};
             size_t i = datalen;
 
             // Pad whatever data is left in the buffer.
@@ -224,7 +392,7 @@ namespace crypt{
                 data[i++] = 0x80;
                 while(i < 64)
                     data[i++] = 0x00;
-                transform();
+                transform(state, data.data());
                 for(std::size_t j = 0; j < 56; j++)
                     data[j] = 0;
             }
@@ -239,7 +407,7 @@ namespace crypt{
             data[61] = static_cast<std::uint8_t>(bitlen >> 40);
             data[62] = static_cast<std::uint8_t>(bitlen >> 48);
             data[63] = static_cast<std::uint8_t>(bitlen >> 56);
-            transform();
+            transform(state, data.data());
 
             // Since this implementation uses little endian byte ordering and MD uses big endian,
             // reverse all the bytes when copying the final state to the output hash.
@@ -250,9 +418,24 @@ namespace crypt{
                 hash[i + 12] = (state[3] >> (i * 8)) & 0x000000ff;
             }
 
+            impl::probe::final(probe_id, sample);
             return hash;
         }
+
+        // digest of [first, last), usable in constant expressions
+        template<typename Iterator>
+        static constexpr std::array<std::uint8_t, 16> hash(Iterator first, Iterator last){
+            basic_md5 algo;
+            algo.update(first, last);
+            return algo.final();
+        }
+
+        static constexpr std::array<std::uint8_t, 16> hash(std::string_view str){
+            return hash(str.begin(), str.end());
+        }
     };
+
+    using md5 = basic_md5<policy::fast>;
 }
 
 #endif /* LIBCRYPT_MD5_HPP */
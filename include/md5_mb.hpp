@@ -0,0 +1,173 @@
+/**
+ * @file   libcrypt/include/md5_mb.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  multi-buffer md5
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_MD5_MB_HPP
+#define LIBCRYPT_MD5_MB_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "impl.hpp"
+#include "md5.hpp"
+#include "multibuffer.hpp"
+
+namespace crypt{
+    namespace impl{
+#if defined(LIBCRYPT_X86_KERNELS)
+LIBCRYPT_MB_BEGIN
+        namespace mb{
+            // md5 compression of one block per lane, the rounds are md5::transform()'s
+            template<typename V>
+            LIBCRYPT_FORCE_INLINE void md5_compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                constexpr std::size_t lanes = lanes_v<V>;
+                V w[16];
+                load_message<V, false>(w, blocks);
+
+                V a = load<V>(state + 0 * lanes);
+                V b = load<V>(state + 1 * lanes);
+                V c = load<V>(state + 2 * lanes);
+                V d = load<V>(state + 3 * lanes);
+
+                md5_rounds(a, b, c, d, w);
+
+                store(state + 0 * lanes, load<V>(state + 0 * lanes) + a);
+                store(state + 1 * lanes, load<V>(state + 1 * lanes) + b);
+                store(state + 2 * lanes, load<V>(state + 2 * lanes) + c);
+                store(state + 3 * lanes, load<V>(state + 3 * lanes) + d);
+            }
+        }
+LIBCRYPT_MB_END
+
+        template<std::size_t Lanes>
+        struct md5_lanes{
+            inline constexpr static std::size_t lanes = Lanes;
+            inline constexpr static std::size_t words = 4;
+            inline constexpr static bool big_endian = false;
+            inline constexpr static std::array<std::uint32_t, 4> iv{
+                0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476
+            };
+
+            static void digest(const std::uint32_t* state, std::size_t lane, std::uint8_t* out){
+                for(std::size_t w = 0; w < words; ++w){
+                    const std::uint32_t v = state[w * lanes + lane];
+                    out[w * 4]     = static_cast<std::uint8_t>(v);
+                    out[w * 4 + 1] = static_cast<std::uint8_t>(v >>  8);
+                    out[w * 4 + 2] = static_cast<std::uint8_t>(v >> 16);
+                    out[w * 4 + 3] = static_cast<std::uint8_t>(v >> 24);
+                }
+            }
+        };
+
+        struct md5_sse2 : md5_lanes<4>{
+            __attribute__((target("sse2"), noinline))
+            static void compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                mb::md5_compress<mb::u32x4>(state, blocks);
+            }
+        };
+
+        struct md5_avx2 : md5_lanes<8>{
+            __attribute__((target("avx2"), noinline))
+            static void compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                mb::md5_compress<mb::u32x8>(state, blocks);
+            }
+        };
+
+        struct md5_avx512 : md5_lanes<16>{
+            __attribute__((target("avx512f"), noinline))
+            static void compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                mb::md5_compress<mb::u32x16>(state, blocks);
+            }
+        };
+#endif
+    }
+
+    /**
+     * Multi-buffer md5: hashes many independent messages at once, one
+     * message per SIMD lane (4 lanes with SSE2, 8 with AVX2, 16 with
+     * AVX-512). Otherwise every message is hashed on its own with md5, the
+     * digests are the same either way.
+     */
+    template<std::size_t Lanes>
+    class md5_mb{
+        static_assert(Lanes == 4 || Lanes == 8 || Lanes == 16,
+                      "crypt::md5_mb: Lanes must be 4, 8 or 16");
+
+    public:
+        using digest_type = std::array<std::uint8_t, 16>;
+        inline constexpr static std::size_t lanes = Lanes;
+
+        // true if the lanes run in SIMD registers on this CPU
+        static bool accelerated(){
+#if defined(LIBCRYPT_X86_KERNELS)
+            if constexpr(Lanes == 4)
+                return impl::cpu::sse2();
+            else if constexpr(Lanes == 8)
+                return impl::cpu::avx2();
+            else
+                return impl::cpu::avx512f();
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Hash count messages, message i is lengths[i] bytes at messages[i]
+         * and its digest is written to digests[i].
+         */
+        static void hash(const std::uint8_t* const* messages, const std::size_t* lengths,
+                         std::size_t count, digest_type* digests){
+#if defined(LIBCRYPT_X86_KERNELS)
+            if(accelerated()){
+                using kernel = std::conditional_t<Lanes == 4, impl::md5_sse2,
+                               std::conditional_t<Lanes == 8, impl::md5_avx2,
+                                                              impl::md5_avx512>>;
+                impl::mb::run<kernel>(messages, lengths, count, digests);
+                return;
+            }
+#endif
+            impl::mb::run_serial<md5>(messages, lengths, count, digests);
+        }
+
+        // Hash every element of a range of contiguous byte containers.
+        template<typename Messages>
+        static std::vector<digest_type> hash(const Messages& messages){
+            return impl::mb::hash_range<md5_mb>(messages);
+        }
+    };
+
+    using md5_x4  = md5_mb<4>;
+    using md5_x8  = md5_mb<8>;
+    using md5_x16 = md5_mb<16>;
+}
+
+#endif /* LIBCRYPT_MD5_MB_HPP */
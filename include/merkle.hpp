@@ -0,0 +1,203 @@
+/**
+ * @file   libcrypt/include/merkle.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  parallel Merkle tree hashing mode
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_MERKLE_HPP
+#define LIBCRYPT_MERKLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "impl.hpp"
+#include "thread_pool.hpp"
+
+namespace crypt{
+    /**
+     * Tree hashing mode on top of Hash.
+     *
+     * The input is split into leaves of chunk_size bytes (the last one may be
+     * shorter), leaves are hashed in parallel on a thread pool and combined
+     * into a root like RFC 6962:
+     *
+     *   leaf = Hash(0x00 || chunk)
+     *   node = Hash(0x01 || left || right)
+     *
+     * where a tree of n leaves is split after the largest power of two below n.
+     * An empty input is a single empty leaf. The root depends on chunk_size,
+     * it is not the plain Hash of the input.
+     */
+    template<typename Hash>
+    class merkle{
+    public:
+        using digest_type = decltype(std::declval<Hash&>().final());
+        inline constexpr static std::size_t default_chunk_size = 1 << 20;
+
+    private:
+        std::size_t chunk;
+        thread_pool* pool;
+        std::size_t batch;                // leaves hashed per parallel round
+        std::vector<std::uint8_t> pending;
+        std::vector<std::pair<digest_type, std::uint64_t>> stack;  // subtree roots and their leaf count
+        std::uint64_t leaves;
+
+        static digest_type node(const digest_type& left, const digest_type& right){
+            Hash algo;
+            algo.update(std::uint8_t{0x01});
+            algo.update(left.begin(), left.end());
+            algo.update(right.begin(), right.end());
+            return algo.final();
+        }
+
+        void push(const digest_type& leaf){
+            stack.emplace_back(leaf, 1);
+            ++leaves;
+            while(stack.size() >= 2 && stack[stack.size() - 1].second == stack[stack.size() - 2].second){
+                auto right = stack.back();
+                stack.pop_back();
+                stack.back().first = node(stack.back().first, right.first);
+                stack.back().second += right.second;
+            }
+        }
+
+        // hash the leaves of [first, first + len) in parallel, the last leaf may be short
+        void hash_leaves(const std::uint8_t* first, std::size_t len){
+            const std::size_t count = std::max<std::size_t>((len + chunk - 1) / chunk, 1);
+            std::vector<digest_type> digests(count);
+
+            pool->parallel_for(count, [&](std::size_t i){
+                const std::uint8_t* begin = first + i * chunk;
+                const std::uint8_t* end = first + std::min(len, (i + 1) * chunk);
+                Hash algo;
+                algo.update(std::uint8_t{0x00});
+                algo.update(begin, end);
+                digests[i] = algo.final();
+            });
+
+            for(const auto& digest : digests)
+                push(digest);
+        }
+
+        void update_contiguous(const std::uint8_t* first, std::size_t len){
+            const std::size_t capacity = batch * chunk;
+
+            if(!pending.empty()){
+                const std::size_t fill = std::min(len, capacity - pending.size());
+                pending.insert(pending.end(), first, first + fill);
+                first += fill;
+                len -= fill;
+                if(pending.size() != capacity)
+                    return;
+                hash_leaves(pending.data(), pending.size());
+                pending.clear();
+            }
+
+            // large inputs are hashed straight from the caller's memory
+            if(len >= capacity){
+                const std::size_t full = len / chunk * chunk;
+                hash_leaves(first, full);
+                first += full;
+                len -= full;
+            }
+            pending.insert(pending.end(), first, first + len);
+        }
+
+    public:
+        explicit merkle(std::size_t chunk_size = default_chunk_size, thread_pool& workers = thread_pool::global()):
+            chunk{chunk_size},
+            pool{&workers},
+            batch{2 * workers.size()}{
+            if(chunk == 0)
+                throw std::invalid_argument("crypt::merkle: chunk_size must not be 0");
+            reset();
+        }
+
+        ~merkle();
+
+        void reset(){
+            pending.clear();
+            stack.clear();
+            leaves = 0;
+        }
+
+        template<typename T>
+        void update(const T& byte){
+            static_assert((sizeof(T) == 1),
+                          "crypt::merkle::update: T must be byte");
+            const std::uint8_t b = static_cast<std::uint8_t>(byte);
+            update_contiguous(&b, 1);
+        }
+
+        template<typename Iterator>
+        void update(Iterator first, Iterator last){
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::merkle::update: T::value_type must be byte");
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(first != last)
+                    update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first),
+                                      static_cast<std::size_t>(last - first));
+            }else{
+                for(; first != last; ++first){
+                    update(*first);
+                }
+            }
+        }
+
+        digest_type final(){
+            if(!pending.empty() || leaves == 0)
+                hash_leaves(pending.data(), pending.size());
+            pending.clear();
+
+            digest_type root = stack.back().first;
+            for(std::size_t i = stack.size() - 1; i != 0; --i)
+                root = node(stack[i - 1].first, root);
+            return root;
+        }
+
+        // one-shot tree hash of [first, last)
+        template<typename Iterator>
+        static digest_type hash(Iterator first, Iterator last,
+                                std::size_t chunk_size = default_chunk_size,
+                                thread_pool& workers = thread_pool::global()){
+            merkle algo{chunk_size, workers};
+            algo.update(first, last);
+            return algo.final();
+        }
+    };
+
+    // defined out of class so it is not implicitly inline (-Winline on the cleanup paths)
+    template<typename Hash>
+    merkle<Hash>::~merkle() = default;
+}
+
+#endif /* LIBCRYPT_MERKLE_HPP */
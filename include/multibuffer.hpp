@@ -0,0 +1,248 @@
+/**
+ * @file   libcrypt/include/multibuffer.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  multi-buffer hashing of independent messages
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_MULTIBUFFER_HPP
+#define LIBCRYPT_MULTIBUFFER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "impl.hpp"
+
+namespace crypt{
+    namespace impl{
+        namespace mb{
+#if defined(LIBCRYPT_X86_KERNELS)
+// The lane kernels are always inlined into a function built for the
+// matching ISA, so vectors never cross an ABI boundary.
+#if defined(__clang__)
+#define LIBCRYPT_MB_BEGIN _Pragma("clang diagnostic push")
+#define LIBCRYPT_MB_END   _Pragma("clang diagnostic pop")
+#else
+#define LIBCRYPT_MB_BEGIN _Pragma("GCC diagnostic push") _Pragma("GCC diagnostic ignored \"-Wpsabi\"")
+#define LIBCRYPT_MB_END   _Pragma("GCC diagnostic pop")
+#endif
+
+LIBCRYPT_MB_BEGIN
+
+// rotations on whole lane vectors
+#define LIBCRYPT_MB_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define LIBCRYPT_MB_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+            // one vector holds the same 32 bit word of every lane
+            typedef std::uint32_t u32x4  __attribute__((vector_size(16)));
+            typedef std::uint32_t u32x8  __attribute__((vector_size(32)));
+            typedef std::uint32_t u32x16 __attribute__((vector_size(64)));
+
+            template<typename V>
+            inline constexpr std::size_t lanes_v = sizeof(V) / sizeof(std::uint32_t);
+
+            template<typename V>
+            LIBCRYPT_FORCE_INLINE V load(const std::uint32_t* p){
+                V v;
+                std::memcpy(&v, p, sizeof(V));
+                return v;
+            }
+
+            template<typename V>
+            LIBCRYPT_FORCE_INLINE void store(std::uint32_t* p, const V& v){
+                std::memcpy(p, &v, sizeof(V));
+            }
+
+            /**
+             * Transpose word t of every lane's block into w[t], BigEndian
+             * selects the byte order of the message words.
+             */
+            template<typename V, bool BigEndian>
+            LIBCRYPT_FORCE_INLINE void load_message(V (&w)[16], const std::uint8_t* const* blocks){
+                constexpr std::size_t lanes = lanes_v<V>;
+                alignas(sizeof(V)) std::uint32_t tmp[16][lanes];
+
+                for(std::size_t l = 0; l < lanes; ++l){
+                    const std::uint8_t* p = blocks[l];
+                    for(std::size_t t = 0; t < 16; ++t, p += 4){
+                        if constexpr(BigEndian)
+                            tmp[t][l] = static_cast<std::uint32_t>((p[0] << 24) | (p[1] << 16) |
+                                                                   (p[2] <<  8) | (p[3]      ));
+                        else
+                            tmp[t][l] = static_cast<std::uint32_t>((p[0]      ) | (p[1] <<  8) |
+                                                                   (p[2] << 16) | (p[3] << 24));
+                    }
+                }
+
+                for(std::size_t t = 0; t < 16; ++t)
+                    w[t] = load<V>(tmp[t]);
+            }
+
+LIBCRYPT_MB_END
+#endif /* LIBCRYPT_X86_KERNELS */
+
+            /**
+             * Cursor over the block stream of one message, including the
+             * Merkle-Damgard padding (0x80, zeros, 64 bit length) shared by
+             * md5, sha1 and sha256.
+             */
+            template<bool BigEndian>
+            class lane{
+                const std::uint8_t* msg = nullptr;
+                std::size_t full  = 0;
+                std::size_t total = 0;
+                std::size_t next  = 0;
+                std::array<std::uint8_t, 128> tail{};
+
+            public:
+                std::size_t index = 0;
+
+                void start(const std::uint8_t* message, std::size_t len, std::size_t idx){
+                    const std::size_t rest = len % 64;
+                    const std::size_t tail_blocks = rest < 56 ? 1 : 2;
+                    const std::uint64_t bitlen = static_cast<std::uint64_t>(len) * 8;
+
+                    msg   = message;
+                    full  = len / 64;
+                    total = full + tail_blocks;
+                    next  = 0;
+                    index = idx;
+
+                    tail.fill(0);
+                    if(rest != 0)
+                        std::memcpy(tail.data(), message + full * 64, rest);
+                    tail[rest] = 0x80;
+
+                    std::uint8_t* end = tail.data() + tail_blocks * 64;
+                    for(std::size_t i = 0; i < 8; ++i){
+                        if constexpr(BigEndian)
+                            end[-1 - static_cast<std::ptrdiff_t>(i)] = static_cast<std::uint8_t>(bitlen >> (i * 8));
+                        else
+                            end[i - 8] = static_cast<std::uint8_t>(bitlen >> (i * 8));
+                    }
+                }
+
+                const std::uint8_t* block() const{
+                    return next < full ? msg + next * 64 : tail.data() + (next - full) * 64;
+                }
+
+                // advance to the next block, true once the last one was consumed
+                bool advance(){
+                    return ++next == total;
+                }
+            };
+
+            /**
+             * Hash `count` independent messages with a lane parallel Kernel.
+             *
+             * Every lane works on its own message, as soon as a lane finished its
+             * last padded block the digest is stored and the lane picks up the next
+             * message, so messages of different lengths keep all lanes busy.
+             *
+             * Kernel provides lanes, words, big_endian, the initial state iv,
+             * compress(state, blocks) on the lane interleaved state and
+             * digest(state, lane, out).
+             */
+            template<typename Kernel, typename Digest>
+            void run(const std::uint8_t* const* messages, const std::size_t* lengths,
+                     std::size_t count, Digest* digests){
+                constexpr std::size_t lanes = Kernel::lanes;
+                constexpr std::size_t words = Kernel::words;
+                alignas(64) static constexpr std::array<std::uint8_t, 64> idle{};
+
+                alignas(64) std::uint32_t state[words * lanes];
+                std::array<lane<Kernel::big_endian>, lanes> cursor;
+                std::array<bool, lanes> active{};
+                std::array<const std::uint8_t*, lanes> blocks;
+                std::size_t pending = 0;
+                std::size_t running = 0;
+
+                auto refill = [&](std::size_t l){
+                    active[l] = pending < count;
+                    if(!active[l])
+                        return;
+                    cursor[l].start(messages[pending], lengths[pending], pending);
+                    for(std::size_t w = 0; w < words; ++w)
+                        state[w * lanes + l] = Kernel::iv[w];
+                    ++pending;
+                    ++running;
+                };
+
+                for(std::size_t l = 0; l < lanes; ++l)
+                    refill(l);
+
+                while(running != 0){
+                    for(std::size_t l = 0; l < lanes; ++l)
+                        blocks[l] = active[l] ? cursor[l].block() : idle.data();
+
+                    Kernel::compress(state, blocks.data());
+
+                    for(std::size_t l = 0; l < lanes; ++l){
+                        if(!active[l] || !cursor[l].advance())
+                            continue;
+                        Kernel::digest(state, l, digests[cursor[l].index].data());
+                        --running;
+                        refill(l);
+                    }
+                }
+            }
+
+            // Hash every message on its own, the fallback without lane kernels.
+            template<typename Hash, typename Digest>
+            void run_serial(const std::uint8_t* const* messages, const std::size_t* lengths,
+                            std::size_t count, Digest* digests){
+                for(std::size_t i = 0; i < count; ++i){
+                    Hash algo;
+                    algo.update(messages[i], messages[i] + lengths[i]);
+                    digests[i] = algo.final();
+                }
+            }
+
+            // MB::hash() over a range of contiguous byte containers.
+            template<typename MB, typename Messages>
+            std::vector<typename MB::digest_type> hash_range(const Messages& messages){
+                std::vector<const std::uint8_t*> pointers;
+                std::vector<std::size_t> lengths;
+                for(const auto& message : messages){
+                    static_assert((sizeof(*std::data(message)) == 1),
+                                  "crypt::mb::hash: Messages::value_type::value_type must be byte");
+                    pointers.push_back(reinterpret_cast<const std::uint8_t*>(std::data(message)));
+                    lengths.push_back(std::size(message));
+                }
+
+                std::vector<typename MB::digest_type> digests(pointers.size());
+                MB::hash(pointers.data(), lengths.data(), pointers.size(), digests.data());
+                return digests;
+            }
+        }
+    }
+}
+
+#endif /* LIBCRYPT_MULTIBUFFER_HPP */
@@ -0,0 +1,268 @@
+/**
+ * @file   libcrypt/include/pbkdf2.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  password-based key derivation function 2 (RFC 8018)
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_PBKDF2_HPP
+#define LIBCRYPT_PBKDF2_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "hmac.hpp"
+#include "impl.hpp"
+#include "sha256_mb.hpp"
+#include "thread_pool.hpp"
+
+namespace crypt{
+    /**
+     * PBKDF2 with HMAC over Hash.
+     *
+     * Every output block T_i = U_1 ^ ... ^ U_c is derived on its own:
+     *
+     *   U_1 = HMAC(P, S || INT(i))
+     *   U_j = HMAC(P, U_j-1)
+     *
+     * The key pads are compressed once per password. After U_1 every
+     * iteration is exactly two compressions on the cached ipad/opad
+     * midstates: U_j-1 always fills the same single block with fixed
+     * padding, so the generic update/final path is skipped. The output
+     * blocks of one or many derivations run in parallel on a thread pool,
+     * and for sha256/sha224 full groups of blocks share the SIMD lanes of
+     * the multi-buffer kernels where the CPU has them.
+     */
+    template<typename Hash>
+    class pbkdf2{
+    public:
+        using hash_type = Hash;
+        static constexpr std::size_t digest_size = Hash::digest_size;
+
+        // one derivation of a batch, writes len bytes to out
+        struct request{
+            std::string_view password;
+            std::string_view salt;
+            std::uint8_t* out;
+            std::size_t len;
+        };
+
+    private:
+        using midstate_type = typename Hash::midstate_type;
+        static constexpr std::size_t block_size = Hash::block_size;
+
+        // output block T_i, block holds U_j followed by its fixed padding
+        struct task{
+            const hmac<Hash>* key;
+            std::string_view salt;
+            std::uint32_t index;
+            std::uint8_t* out;
+            std::size_t len;
+            std::array<std::uint8_t, block_size> block;
+            std::array<std::uint8_t, digest_size> sum;
+        };
+
+        // U_1 into the block, with the padding of a digest after one key block
+        static void first(task& t){
+            hmac<Hash> algo = *t.key;
+            const std::uint8_t index[4] = {static_cast<std::uint8_t>(t.index >> 24),
+                                           static_cast<std::uint8_t>(t.index >> 16),
+                                           static_cast<std::uint8_t>(t.index >> 8),
+                                           static_cast<std::uint8_t>(t.index)};
+            algo.update(t.salt.begin(), t.salt.end());
+            algo.update(index, index + 4);
+            const auto u = algo.final();
+
+            const std::uint64_t bitlen = (block_size + digest_size) * 8;
+            t.block.fill(0);
+            std::memcpy(t.block.data(), u.data(), digest_size);
+            t.block[digest_size] = 0x80;
+            for(std::size_t i = 0; i < 8; ++i){
+                if constexpr(Hash::big_endian)
+                    t.block[block_size - 1 - i] = static_cast<std::uint8_t>(bitlen >> (i * 8));
+                else
+                    t.block[block_size - 8 + i] = static_cast<std::uint8_t>(bitlen >> (i * 8));
+            }
+            std::memcpy(t.sum.data(), u.data(), digest_size);
+        }
+
+        static void store(const task& t){
+            std::memcpy(t.out, t.sum.data(), t.len);
+        }
+
+        // U_2 to U_c of one block on the single stream kernels
+        static void iterate(task& t, std::uint32_t iterations){
+            const midstate_type& ipad = t.key->inner_midstate();
+            const midstate_type& opad = t.key->outer_midstate();
+            for(std::uint32_t j = 1; j < iterations; ++j){
+                midstate_type inner = ipad;
+                Hash::compress(inner, t.block.data(), 1);
+                impl::store_digest<Hash::big_endian>(inner.state, t.block.data(), digest_size);
+
+                midstate_type outer = opad;
+                Hash::compress(outer, t.block.data(), 1);
+                impl::store_digest<Hash::big_endian>(outer.state, t.block.data(), digest_size);
+
+                for(std::size_t i = 0; i < digest_size; ++i)
+                    t.sum[i] ^= t.block[i];
+            }
+        }
+
+#if defined(LIBCRYPT_X86_KERNELS)
+        // U_2 to U_c of Kernel::lanes blocks at once, one block per lane
+        template<typename Kernel>
+        static void iterate_lanes(task* tasks, std::uint32_t iterations){
+            constexpr std::size_t lanes = Kernel::lanes;
+            constexpr std::size_t words = Kernel::words;
+            alignas(64) std::uint32_t ipad[words * lanes];
+            alignas(64) std::uint32_t opad[words * lanes];
+            alignas(64) std::uint32_t state[words * lanes];
+            const std::uint8_t* blocks[lanes];
+
+            for(std::size_t l = 0; l < lanes; ++l){
+                for(std::size_t w = 0; w < words; ++w){
+                    ipad[w * lanes + l] = tasks[l].key->inner_midstate().state[w];
+                    opad[w * lanes + l] = tasks[l].key->outer_midstate().state[w];
+                }
+                blocks[l] = tasks[l].block.data();
+            }
+
+            for(std::uint32_t j = 1; j < iterations; ++j){
+                std::memcpy(state, ipad, sizeof(state));
+                Kernel::compress(state, blocks);
+                for(std::size_t l = 0; l < lanes; ++l)
+                    Kernel::digest(state, l, tasks[l].block.data());
+
+                std::memcpy(state, opad, sizeof(state));
+                Kernel::compress(state, blocks);
+                for(std::size_t l = 0; l < lanes; ++l){
+                    Kernel::digest(state, l, tasks[l].block.data());
+                    for(std::size_t i = 0; i < digest_size; ++i)
+                        tasks[l].sum[i] ^= tasks[l].block[i];
+                }
+            }
+        }
+#endif
+
+        // blocks derived together on the lane kernels, 1 without them
+        static std::size_t lanes(){
+#if defined(LIBCRYPT_X86_KERNELS)
+            if constexpr(std::is_same_v<Hash, sha256> || std::is_same_v<Hash, sha224>){
+                if(sha256_mb<Hash, 16>::accelerated())
+                    return 16;
+                if(sha256_mb<Hash, 8>::accelerated())
+                    return 8;
+            }
+#endif
+            return 1;
+        }
+
+        // all iterations of group g, a full set of lanes or a single block
+        static void run(task* tasks, std::size_t count, std::size_t width, std::size_t g, std::uint32_t iterations){
+            const std::size_t full = count / width;
+            task* group = g < full ? tasks + g * width : tasks + full * width + (g - full);
+            const std::size_t n = g < full ? width : 1;
+
+            for(std::size_t i = 0; i < n; ++i)
+                first(group[i]);
+#if defined(LIBCRYPT_X86_KERNELS)
+            if constexpr(std::is_same_v<Hash, sha256> || std::is_same_v<Hash, sha224>){
+                if(n == 16){
+                    iterate_lanes<impl::sha256_avx512<Hash>>(group, iterations);
+                }else if(n == 8){
+                    iterate_lanes<impl::sha256_avx2<Hash>>(group, iterations);
+                }else{
+                    iterate(group[0], iterations);
+                }
+            }else
+#endif
+            {
+                for(std::size_t i = 0; i < n; ++i)
+                    iterate(group[i], iterations);
+            }
+            for(std::size_t i = 0; i < n; ++i)
+                store(group[i]);
+        }
+
+    public:
+        /**
+         * Derive count requests with the same iteration count. The output
+         * blocks of all of them are spread over the lanes and the threads
+         * of workers together, so a batch of short keys keeps every lane
+         * busy.
+         */
+        static void derive(const request* requests, std::size_t count, std::uint32_t iterations,
+                           thread_pool& workers = thread_pool::global()){
+            if(iterations == 0)
+                throw std::invalid_argument("crypt::pbkdf2::derive: iterations must not be 0");
+
+            std::vector<hmac<Hash>> keys(count);
+            std::vector<task> tasks;
+            for(std::size_t r = 0; r < count; ++r){
+                const request& req = requests[r];
+                if((req.len + digest_size - 1) / digest_size > 0xffffffff)
+                    throw std::length_error("crypt::pbkdf2::derive: derived key too long");
+                keys[r].rekey(req.password.begin(), req.password.end());
+
+                std::uint32_t index = 1;
+                for(std::size_t offset = 0; offset < req.len; offset += digest_size, ++index){
+                    const std::size_t len = req.len - offset < digest_size ? req.len - offset : digest_size;
+                    tasks.push_back(task{&keys[r], req.salt, index, req.out + offset, len, {}, {}});
+                }
+            }
+
+            const std::size_t width = lanes();
+            const std::size_t groups = tasks.size() / width + tasks.size() % width;
+            workers.parallel_for(groups, [&](std::size_t g){
+                run(tasks.data(), tasks.size(), width, g, iterations);
+            });
+        }
+
+        // derive len bytes from password and salt into out
+        static void derive(std::string_view password, std::string_view salt, std::uint32_t iterations,
+                           std::uint8_t* out, std::size_t len,
+                           thread_pool& workers = thread_pool::global()){
+            const request req{password, salt, out, len};
+            derive(&req, 1, iterations, workers);
+        }
+
+        static std::vector<std::uint8_t> derive(std::string_view password, std::string_view salt,
+                                                std::uint32_t iterations, std::size_t len,
+                                                thread_pool& workers = thread_pool::global()){
+            std::vector<std::uint8_t> key(len);
+            derive(password, salt, iterations, key.data(), key.size(), workers);
+            return key;
+        }
+    };
+}
+
+#endif /* LIBCRYPT_PBKDF2_HPP */
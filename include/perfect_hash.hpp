@@ -0,0 +1,232 @@
+/**
+ * @file   libcrypt/include/perfect_hash.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  compile-time perfect hash tables over string keys
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_PERFECT_HASH_HPP
+#define LIBCRYPT_PERFECT_HASH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include "djb2.hpp"
+#include "impl.hpp"
+
+namespace crypt{
+    namespace impl{
+        // murmur3 finalizer, spreads the weak low bits of djb2/sdbm over the word
+        constexpr std::uint32_t fmix32(std::uint32_t h){
+            h ^= h >> 16;
+            h *= 0x85ebca6b;
+            h ^= h >> 13;
+            h *= 0xc2b2ae35;
+            h ^= h >> 16;
+            return h;
+        }
+
+        constexpr std::size_t next_pow2(std::size_t n){
+            std::size_t p = 1;
+            while(p < n)
+                p <<= 1;
+            return p;
+        }
+    }
+
+    /**
+     * Collision free hash table over a fixed set of N keys, built with hash
+     * and displace: keys are grouped into buckets by a seeded Hash, then the
+     * buckets are placed largest first, each with the first displacement
+     * that moves all of its keys into free slots. A lookup hashes the key
+     * once and probes exactly one slot, no heap is involved.
+     *
+     * Hash needs a static hash(std::string_view, std::uint32_t seed), as
+     * provided by djb2 and sdbm. Construction tries MaxSeeds seeds and up to
+     * MaxDisplacement displacements per bucket and throws if that is not
+     * enough, which makes a constexpr table fail to compile. Large key sets
+     * may need a higher -fconstexpr-ops-limit to be built at compile time.
+     */
+    template<std::size_t N, typename Hash = djb2,
+             std::size_t MaxSeeds = 16, std::uint32_t MaxDisplacement = 1u << 16>
+    class perfect_hash{
+        static_assert(N > 0, "crypt::perfect_hash: key set must not be empty");
+        static_assert(MaxDisplacement > 0 && MaxDisplacement < (1u << 31),
+                      "crypt::perfect_hash: MaxDisplacement out of range");
+
+        static constexpr std::size_t slots = impl::next_pow2(N);
+        static constexpr std::size_t mask  = slots - 1;
+
+        std::uint32_t seed_value = 0;
+        // < 0: the only key of the bucket sits in slot ~displacement,
+        // > 0: key slots are fmix32(h ^ displacement) & mask, 0: empty bucket
+        std::array<std::int32_t, slots> displacement{};
+        std::array<std::string_view, slots> key{};
+        std::array<std::size_t, slots> index{}; // npos for free slots
+
+        LIBCRYPT_FORCE_INLINE static constexpr std::uint32_t hash_key(std::string_view str, std::uint32_t seed){
+            return impl::fmix32(Hash::hash(str, seed));
+        }
+
+        static constexpr std::size_t slot_of(std::uint32_t h, std::int32_t d){
+            return d < 0 ? static_cast<std::size_t>(~d)
+                         : impl::fmix32(h ^ static_cast<std::uint32_t>(d)) & mask;
+        }
+
+        // one attempt with seed, false if a bucket could not be placed
+        LIBCRYPT_NOINLINE constexpr bool build(const std::array<std::string_view, N>& keys, std::uint32_t seed){
+            std::array<std::uint32_t, N> h{};
+            std::array<std::size_t, slots + 1> start{};
+            std::array<std::size_t, N> order{};
+
+            // counting sort of the keys by bucket
+            for(std::size_t i = 0; i < N; i++){
+                h[i] = hash_key(keys[i], seed);
+                start[(h[i] & mask) + 1]++;
+            }
+            for(std::size_t b = 0; b < slots; b++)
+                start[b + 1] += start[b];
+            {
+                std::array<std::size_t, slots> fill{};
+                for(std::size_t i = 0; i < N; i++){
+                    const std::size_t b = h[i] & mask;
+                    order[start[b] + fill[b]++] = i;
+                }
+            }
+
+            // and of the buckets by size, largest first
+            std::array<std::size_t, N + 2> by_size{};
+            std::array<std::size_t, slots> buckets{};
+            for(std::size_t b = 0; b < slots; b++)
+                by_size[N - (start[b + 1] - start[b]) + 1]++;
+            for(std::size_t s = 0; s <= N; s++)
+                by_size[s + 1] += by_size[s];
+            for(std::size_t b = 0; b < slots; b++)
+                buckets[by_size[N - (start[b + 1] - start[b])]++] = b;
+
+            std::array<bool, slots> used{};
+            std::array<std::size_t, N> placed{};
+            displacement = {};
+
+            std::size_t next_free = 0;
+            for(std::size_t i = 0; i < slots; i++){
+                const std::size_t b = buckets[i];
+                const std::size_t first = start[b];
+                const std::size_t count = start[b + 1] - first;
+                if(count == 0)
+                    break;
+
+                if(count == 1){
+                    while(used[next_free])
+                        next_free++;
+                    used[next_free] = true;
+                    displacement[b] = ~static_cast<std::int32_t>(next_free);
+                    continue;
+                }
+
+                for(std::size_t j = 1; j < count; j++)
+                    for(std::size_t k = 0; k < j; k++)
+                        if(keys[order[first + j]] == keys[order[first + k]])
+                            throw std::invalid_argument("crypt::perfect_hash: duplicate key");
+
+                std::uint32_t d = 1;
+                for(; d <= MaxDisplacement; d++){
+                    std::size_t j = 0;
+                    for(; j < count; j++){
+                        const std::size_t s = slot_of(h[order[first + j]], static_cast<std::int32_t>(d));
+                        if(used[s])
+                            break;
+                        used[s] = true;
+                        placed[j] = s;
+                    }
+                    if(j == count)
+                        break;
+                    while(j != 0)
+                        used[placed[--j]] = false;
+                }
+                if(d > MaxDisplacement)
+                    return false;
+                displacement[b] = static_cast<std::int32_t>(d);
+            }
+
+            for(std::size_t s = 0; s < slots; s++){
+                key[s] = {};
+                index[s] = npos;
+            }
+            for(std::size_t i = 0; i < N; i++){
+                const std::size_t s = slot_of(h[i], displacement[h[i] & mask]);
+                key[s] = keys[i];
+                index[s] = i;
+            }
+            seed_value = seed;
+            return true;
+        }
+
+    public:
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        LIBCRYPT_NOINLINE constexpr explicit perfect_hash(const std::array<std::string_view, N>& keys){
+            std::uint32_t seed = 0;
+            for(std::size_t i = 0; i < MaxSeeds; i++, seed += 0x9e3779b9)
+                if(build(keys, seed))
+                    return;
+            throw std::length_error("crypt::perfect_hash: no perfect hash within the limits");
+        }
+
+        /**
+         * Position of str in the key set the table was built from, npos if
+         * it is not part of it. Meant for switch dispatch on strings.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr std::size_t find(std::string_view str) const{
+            const std::uint32_t h = hash_key(str, seed_value);
+            const std::size_t s = slot_of(h, displacement[h & mask]);
+            return key[s] == str ? index[s] : npos;
+        }
+
+        LIBCRYPT_FORCE_INLINE constexpr bool contains(std::string_view str) const{
+            return find(str) != npos;
+        }
+
+        constexpr std::size_t size() const{
+            return N;
+        }
+
+        constexpr std::uint32_t seed() const{
+            return seed_value;
+        }
+    };
+
+    // perfect_hash over the given string literals, in that order
+    template<typename Hash = djb2, typename... Keys>
+    constexpr perfect_hash<sizeof...(Keys), Hash> make_perfect_hash(const Keys&... keys){
+        return perfect_hash<sizeof...(Keys), Hash>{std::array<std::string_view, sizeof...(Keys)>{keys...}};
+    }
+}
+
+#endif /* LIBCRYPT_PERFECT_HASH_HPP */
@@ -0,0 +1,487 @@
+/**
+ * @file   libcrypt/include/poly_simd.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  vectorized bulk kernels for the djb2 and sdbm polynomial hashes
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_POLY_SIMD_HPP
+#define LIBCRYPT_POLY_SIMD_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "impl.hpp"
+#include "thread_pool.hpp"
+
+#if defined(LIBCRYPT_X86_KERNELS)
+#include <immintrin.h>
+#endif
+
+namespace crypt{
+    namespace impl{
+        // inputs from this size on go through poly_update
+        inline constexpr std::ptrdiff_t poly_min_simd = 32;
+
+        // inputs from this size on are split across the workers
+        inline constexpr std::size_t poly_parallel_min = 1024 * 1024;
+        // bytes per parallel work item
+        inline constexpr std::size_t poly_parallel_chunk = 256 * 1024;
+        // column rows longer than this leave the gather lanes for poly_update
+        inline constexpr std::int64_t poly_column_long = 64;
+
+        // m^n mod 2^bits of Word
+        template<typename Word>
+        constexpr Word poly_power(Word m, std::uint64_t n){
+            Word r = 1;
+            for(; n != 0; n >>= 1, m *= m)
+                if(n & 1)
+                    r *= m;
+            return r;
+        }
+
+        /**
+         * Hash of A || B from the hash of A, the hash of B and the length
+         * of B, both hashed from seed:
+         *
+         *   h(B)      = seed * M^|B| + P(B)
+         *   h(A || B) = h(A) * M^|B| + P(B) = (h(A) - seed) * M^|B| + h(B)
+         */
+        template<typename Word, std::uint32_t M>
+        constexpr Word poly_combine(Word left, Word right, std::uint64_t right_length, Word seed){
+            return (left - seed) * poly_power<Word>(M, right_length) + right;
+        }
+
+        // M^(N-1) down to M^0, the weight of every byte of an N byte block
+        template<std::uint32_t M, std::size_t N>
+        struct poly_weights{
+            static constexpr std::array<std::uint32_t, N> make(){
+                std::array<std::uint32_t, N> w{};
+                std::uint32_t p = 1;
+                for(std::size_t i = N; i != 0; --i, p *= M)
+                    w[i - 1] = p;
+                return w;
+            }
+
+            alignas(64) inline constexpr static std::array<std::uint32_t, N> value = make();
+        };
+
+        // h = h * M + b, b sign extended like a signed char if Signed
+        template<typename Word, std::uint32_t M, bool Signed>
+        LIBCRYPT_FORCE_INLINE Word poly_scalar(Word h, const std::uint8_t* p, std::size_t n){
+            for(; n != 0; --n, ++p)
+                h = h * M + (Signed ? static_cast<Word>(static_cast<std::int8_t>(*p)) : *p);
+            return h;
+        }
+
+#if defined(LIBCRYPT_X86_KERNELS)
+        /*
+         * The polynomial hash h = h * M + b over blocks of 4 * lanes
+         * bytes. Four accumulators take every fourth vector of bytes, so
+         * four independent multiplies are in flight:
+         *
+         *   a = a * M^(4 * lanes) + bytes
+         *
+         * and every lane is weighted by the power of M of its position at
+         * the end. The result is the one of the scalar loop mod 2^32.
+         */
+#define LIBCRYPT_POLY_FOLD(vec, lanes, load, widen, mul, add, set1)                 \
+        constexpr std::size_t step = 4 * (lanes);                                   \
+        const vec m = set1(static_cast<int>(poly_power(M, step)));                  \
+        vec a0 = set1(0), a1 = a0, a2 = a0, a3 = a0;                                \
+        for(std::size_t i = 0; i < blocks; ++i, p += step){                         \
+            a0 = add(mul(a0, m), widen<Signed>(p));                                 \
+            a1 = add(mul(a1, m), widen<Signed>(p + (lanes)));                       \
+            a2 = add(mul(a2, m), widen<Signed>(p + 2 * (lanes)));                   \
+            a3 = add(mul(a3, m), widen<Signed>(p + 3 * (lanes)));                   \
+        }                                                                           \
+        const std::uint32_t* w = poly_weights<M, step>::value.data();               \
+        vec sum = add(add(mul(a0, load(w)), mul(a1, load(w + (lanes)))),            \
+                      add(mul(a2, load(w + 2 * (lanes))), mul(a3, load(w + 3 * (lanes))))); \
+        alignas(64) std::uint32_t lane[lanes];                                      \
+        std::memcpy(lane, &sum, sizeof(lane));                                      \
+        h *= poly_power(M, static_cast<std::uint64_t>(step) * blocks);              \
+        for(std::size_t l = 0; l < (lanes); ++l)                                    \
+            h += lane[l];                                                           \
+        return h
+
+        namespace poly{
+            template<bool Signed>
+            __attribute__((target("sse4.1"), always_inline)) inline __m128i widen128(const std::uint8_t* p){
+                std::uint32_t v;
+                std::memcpy(&v, p, sizeof(v));
+                const __m128i b = _mm_cvtsi32_si128(static_cast<int>(v));
+                return Signed ? _mm_cvtepi8_epi32(b) : _mm_cvtepu8_epi32(b);
+            }
+
+            template<bool Signed>
+            __attribute__((target("avx2"), always_inline)) inline __m256i widen256(const std::uint8_t* p){
+                const __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+                return Signed ? _mm256_cvtepi8_epi32(b) : _mm256_cvtepu8_epi32(b);
+            }
+
+            template<bool Signed>
+            __attribute__((target("avx512f"), always_inline)) inline __m512i widen512(const std::uint8_t* p){
+                // the zero masked forms, the plain ones trip -Wmaybe-uninitialized in GCC 12
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                return Signed ? _mm512_maskz_cvtepi8_epi32(0xffff, b) : _mm512_maskz_cvtepu8_epi32(0xffff, b);
+            }
+
+            __attribute__((target("sse4.1"), always_inline)) inline __m128i load128(const std::uint32_t* p){
+                return _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+            }
+
+            __attribute__((target("avx2"), always_inline)) inline __m256i load256(const std::uint32_t* p){
+                return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+            }
+        }
+
+        template<std::uint32_t M, bool Signed>
+        __attribute__((target("sse4.1"), noinline))
+        std::uint32_t poly_sse41(std::uint32_t h, const std::uint8_t* p, std::size_t blocks){
+            LIBCRYPT_POLY_FOLD(__m128i, 4, poly::load128, poly::widen128,
+                               _mm_mullo_epi32, _mm_add_epi32, _mm_set1_epi32);
+        }
+
+        template<std::uint32_t M, bool Signed>
+        __attribute__((target("avx2"), noinline))
+        std::uint32_t poly_avx2(std::uint32_t h, const std::uint8_t* p, std::size_t blocks){
+            LIBCRYPT_POLY_FOLD(__m256i, 8, poly::load256, poly::widen256,
+                               _mm256_mullo_epi32, _mm256_add_epi32, _mm256_set1_epi32);
+        }
+
+        template<std::uint32_t M, bool Signed>
+        __attribute__((target("avx512f"), noinline))
+        std::uint32_t poly_avx512(std::uint32_t h, const std::uint8_t* p, std::size_t blocks){
+            LIBCRYPT_POLY_FOLD(__m512i, 16, _mm512_load_si512, poly::widen512,
+                               _mm512_mullo_epi32, _mm512_add_epi32, _mm512_set1_epi32);
+        }
+
+#undef LIBCRYPT_POLY_FOLD
+
+        /*
+         * Column kernels, one row per lane. Every step gathers the next
+         * four bytes of the rows that have four left and folds them in as
+         *
+         *   h = h * M^4 + b0 * M^3 + b1 * M^2 + b2 * M + b3
+         *
+         * The remaining 0 to 3 bytes are gathered as the last word of the
+         * row with the leading bytes masked off, so no lane reads past the
+         * end of its row, and folded with M^r instead of M^4.
+         */
+        namespace poly{
+            template<std::uint32_t M>
+            alignas(64) inline constexpr std::uint32_t tail_power[16] = {
+                1, M, M * M, M * M * M
+            };
+
+            template<bool Signed>
+            __attribute__((target("avx2"), always_inline)) inline __m256i word256(__m256i w, std::uint32_t m){
+                const __m256i b0 = Signed ? _mm256_srai_epi32(_mm256_slli_epi32(w, 24), 24) : _mm256_and_si256(w, _mm256_set1_epi32(0xff));
+                const __m256i b1 = Signed ? _mm256_srai_epi32(_mm256_slli_epi32(w, 16), 24) : _mm256_and_si256(_mm256_srli_epi32(w, 8), _mm256_set1_epi32(0xff));
+                const __m256i b2 = Signed ? _mm256_srai_epi32(_mm256_slli_epi32(w, 8), 24) : _mm256_and_si256(_mm256_srli_epi32(w, 16), _mm256_set1_epi32(0xff));
+                const __m256i b3 = Signed ? _mm256_srai_epi32(w, 24) : _mm256_srli_epi32(w, 24);
+                return _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(b0, _mm256_set1_epi32(static_cast<int>(m * m * m))),
+                                                         _mm256_mullo_epi32(b1, _mm256_set1_epi32(static_cast<int>(m * m)))),
+                                        _mm256_add_epi32(_mm256_mullo_epi32(b2, _mm256_set1_epi32(static_cast<int>(m))), b3));
+            }
+
+            __attribute__((target("avx2"), always_inline)) inline std::int32_t max256(__m256i v){
+                v = _mm256_max_epi32(v, _mm256_permute2x128_si256(v, v, 1));
+                v = _mm256_max_epi32(v, _mm256_shuffle_epi32(v, 0x4e));
+                v = _mm256_max_epi32(v, _mm256_shuffle_epi32(v, 0xb1));
+                return _mm256_cvtsi256_si32(v);
+            }
+
+            // the plain AVX-512 shift intrinsics trip -Wmaybe-uninitialized in GCC 12, so vector operators
+            template<bool Signed>
+            __attribute__((target("avx512f"), always_inline)) inline __m512i word512(__m512i v, std::uint32_t m){
+                const __v16si w = reinterpret_cast<__v16si>(v);
+                const __v16su u = reinterpret_cast<__v16su>(v);
+                const __v16si b0 = Signed ? (w << 24) >> 24 : reinterpret_cast<__v16si>(u & 0xff);
+                const __v16si b1 = Signed ? (w << 16) >> 24 : reinterpret_cast<__v16si>((u >> 8) & 0xff);
+                const __v16si b2 = Signed ? (w << 8) >> 24 : reinterpret_cast<__v16si>((u >> 16) & 0xff);
+                const __v16si b3 = Signed ? w >> 24 : reinterpret_cast<__v16si>(u >> 24);
+                const __v16su sum = reinterpret_cast<__v16su>(b0) * (m * m * m) + reinterpret_cast<__v16su>(b1) * (m * m)
+                                  + reinterpret_cast<__v16su>(b2) * m + reinterpret_cast<__v16su>(b3);
+                return reinterpret_cast<__m512i>(sum);
+            }
+        }
+
+        template<std::uint32_t M, bool Signed>
+        __attribute__((target("avx2"), noinline))
+        unsigned poly_column_avx2(const std::uint8_t* base, const std::int32_t* bounds,
+                                  std::uint32_t seed, std::uint32_t* out){
+            const int* words = reinterpret_cast<const int*>(base);
+            const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds));
+            __m256i len = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bounds + 1)), first);
+            const __m256i long_rows = _mm256_cmpgt_epi32(len, _mm256_set1_epi32(poly_column_long));
+            len = _mm256_andnot_si256(long_rows, len);
+            const __m256i quads = _mm256_srli_epi32(len, 2);
+            const std::int32_t steps = poly::max256(quads);
+            const __m256i m4 = _mm256_set1_epi32(static_cast<int>(poly_power(M, 4)));
+            __m256i pos = first;
+            __m256i h = _mm256_set1_epi32(static_cast<int>(seed));
+
+            for(std::int32_t j = 0; j < steps; ++j){
+                const __m256i active = _mm256_cmpgt_epi32(quads, _mm256_set1_epi32(j));
+                const __m256i w = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), words, pos, active, 1);
+                const __m256i next = _mm256_add_epi32(_mm256_mullo_epi32(h, m4), poly::word256<Signed>(w, M));
+                h = _mm256_blendv_epi8(h, next, active);
+                pos = _mm256_add_epi32(pos, _mm256_set1_epi32(4));
+            }
+
+            const __m256i rest = _mm256_and_si256(len, _mm256_set1_epi32(3));
+            const __m256i active = _mm256_cmpgt_epi32(rest, _mm256_setzero_si256());
+            const __m256i last = _mm256_sub_epi32(_mm256_add_epi32(first, len), _mm256_set1_epi32(4));
+            __m256i w = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), words, last, active, 1);
+            w = _mm256_and_si256(w, _mm256_sllv_epi32(_mm256_set1_epi32(-1),
+                                                      _mm256_sub_epi32(_mm256_set1_epi32(32), _mm256_slli_epi32(rest, 3))));
+            const __m256i power = _mm256_permutevar8x32_epi32(
+                _mm256_load_si256(reinterpret_cast<const __m256i*>(poly::tail_power<M>)), rest);
+            h = _mm256_add_epi32(_mm256_mullo_epi32(h, power), poly::word256<Signed>(w, M));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), h);
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(long_rows)));
+        }
+
+        template<std::uint32_t M, bool Signed>
+        __attribute__((target("avx512f"), noinline))
+        unsigned poly_column_avx512(const std::uint8_t* base, const std::int32_t* bounds,
+                                    std::uint32_t seed, std::uint32_t* out){
+            const __m512i first = _mm512_loadu_si512(bounds);
+            __m512i len = _mm512_sub_epi32(_mm512_loadu_si512(bounds + 1), first);
+            const __mmask16 long_rows = _mm512_cmpgt_epi32_mask(len, _mm512_set1_epi32(poly_column_long));
+            len = _mm512_maskz_mov_epi32(static_cast<__mmask16>(~long_rows), len);
+            const __m512i quads = reinterpret_cast<__m512i>(reinterpret_cast<__v16su>(len) >> 2);
+            const std::int32_t steps = poly::max256(_mm256_max_epi32(_mm512_maskz_extracti64x4_epi64(0xff, quads, 0),
+                                                                     _mm512_maskz_extracti64x4_epi64(0xff, quads, 1)));
+            const __m512i m4 = _mm512_set1_epi32(static_cast<int>(poly_power(M, 4)));
+            __m512i pos = first;
+            __m512i h = _mm512_set1_epi32(static_cast<int>(seed));
+
+            for(std::int32_t j = 0; j < steps; ++j){
+                const __mmask16 active = _mm512_cmpgt_epi32_mask(quads, _mm512_set1_epi32(j));
+                const __m512i w = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), active, pos, base, 1);
+                h = _mm512_mask_add_epi32(h, active, _mm512_mullo_epi32(h, m4), poly::word512<Signed>(w, M));
+                pos = _mm512_add_epi32(pos, _mm512_set1_epi32(4));
+            }
+
+            // rows without a tail gather nothing, so their mask (shift 0) does not matter
+            const __v16su rest = reinterpret_cast<__v16su>(len) & 3;
+            const __mmask16 active = _mm512_cmpgt_epi32_mask(reinterpret_cast<__m512i>(rest), _mm512_setzero_si512());
+            const __m512i last = _mm512_sub_epi32(_mm512_add_epi32(first, len), _mm512_set1_epi32(4));
+            const __m512i w = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), active, last, base, 1);
+            const __v16su keep = ~__v16su{} << ((32 - 8 * rest) & 31);
+            const __m512i power = _mm512_maskz_permutexvar_epi32(0xffff, reinterpret_cast<__m512i>(rest),
+                                                                 _mm512_load_si512(poly::tail_power<M>));
+            h = _mm512_add_epi32(_mm512_mullo_epi32(h, power),
+                                 poly::word512<Signed>(reinterpret_cast<__m512i>(reinterpret_cast<__v16su>(w) & keep), M));
+            _mm512_storeu_si512(out, h);
+            return long_rows;
+        }
+#endif
+
+        /**
+         * Bulk update of the djb2/sdbm style hash h = h * M + b, bit
+         * identical to the byte loop. For 32 bit words whole blocks go
+         * through the widest kernel the CPU has (64 bytes with AVX-512, 32
+         * with AVX2, 16 with SSE4.1), the tail through the narrower ones
+         * and the scalar loop. 64 bit words take the scalar loop.
+         */
+        template<typename Word, std::uint32_t M, bool Signed>
+        struct poly_update{
+            // the kernels from Widest bytes per block down, then the scalar loop
+            template<std::size_t Widest>
+            static Word cascade(Word h, const std::uint8_t* p, std::size_t n){
+#if defined(LIBCRYPT_X86_KERNELS)
+                if constexpr(std::is_same_v<Word, std::uint32_t>){
+                    if constexpr(Widest >= 64){
+                        if(n >= 64){
+                            h = poly_avx512<M, Signed>(h, p, n / 64);
+                            p += n / 64 * 64;
+                            n %= 64;
+                        }
+                    }
+                    if constexpr(Widest >= 32){
+                        if(n >= 32){
+                            h = poly_avx2<M, Signed>(h, p, n / 32);
+                            p += n / 32 * 32;
+                            n %= 32;
+                        }
+                    }
+                    if constexpr(Widest >= 16){
+                        if(n >= 16){
+                            h = poly_sse41<M, Signed>(h, p, n / 16);
+                            p += n / 16 * 16;
+                            n %= 16;
+                        }
+                    }
+                }
+#endif
+                return poly_scalar<Word, M, Signed>(h, p, n);
+            }
+
+            using bulk_fn = Word(Word, const std::uint8_t*, std::size_t);
+
+            // in order of preference, 64 bit words only have the scalar loop
+            inline constexpr static kernel<bulk_fn> bulk_kernels[] = {
+#if defined(LIBCRYPT_X86_KERNELS)
+                {"avx512", cpu::avx512f, cascade<64>},
+                {"avx2", cpu::avx2, cascade<32>},
+                {"sse4.1", cpu::sse41, cascade<16>},
+#endif
+                {"scalar", cpu::portable, cascade<0>}
+            };
+            inline static dispatch<bulk_fn> bulk{bulk_kernels};
+
+            static const char* kernel_name(){
+                if constexpr(std::is_same_v<Word, std::uint32_t>)
+                    return bulk.active().name;
+                else
+                    return "scalar";
+            }
+
+            LIBCRYPT_NOINLINE static Word run(Word h, const std::uint8_t* p, std::size_t n){
+                if constexpr(std::is_same_v<Word, std::uint32_t>)
+                    return bulk.active().entry(h, p, n);
+                else
+                    return poly_scalar<Word, M, Signed>(h, p, n);
+            }
+
+            /**
+             * Like run, with inputs of poly_parallel_min bytes and more
+             * cut into chunks that are hashed from 0 on the workers and
+             * folded in order, h = h * M^|chunk| + h(chunk).
+             */
+            LIBCRYPT_NOINLINE static Word run(Word h, const std::uint8_t* p, std::size_t n, thread_pool& workers){
+                if(n < poly_parallel_min || workers.size() < 2)
+                    return run(h, p, n);
+
+                const std::size_t chunks = (n + poly_parallel_chunk - 1) / poly_parallel_chunk;
+                std::vector<Word> partial(chunks);
+                workers.parallel_for(chunks, [&](std::size_t i){
+                    const std::size_t offset = i * poly_parallel_chunk;
+                    partial[i] = run(0, p + offset, std::min(poly_parallel_chunk, n - offset));
+                });
+
+                constexpr Word step = poly_power<Word>(M, poly_parallel_chunk);
+                for(std::size_t i = 0; i + 1 < chunks; ++i)
+                    h = h * step + partial[i];
+                return h * poly_power<Word>(M, n - (chunks - 1) * poly_parallel_chunk) + partial[chunks - 1];
+            }
+        };
+
+        /**
+         * Hashes of the rows of an offsets + bytes string column, row i is
+         * [bytes + offsets[i], bytes + offsets[i + 1]). Groups of 16 (AVX-512)
+         * or 8 (AVX2) rows go through the column kernels, one row per lane.
+         * Long rows, groups the 32 bit gather indices can not address, 64
+         * bit words and CPUs without gathers take poly_update row by row.
+         */
+        template<typename Word, std::uint32_t M, bool Signed>
+        struct poly_column{
+            template<typename Offset>
+            static void serial(const std::uint8_t* bytes, const Offset* offsets, std::size_t rows,
+                               Word* hashes, Word seed){
+                for(std::size_t i = 0; i < rows; ++i){
+                    const std::uint8_t* p = bytes + offsets[i];
+                    const std::size_t n = static_cast<std::size_t>(offsets[i + 1] - offsets[i]);
+                    hashes[i] = n >= static_cast<std::size_t>(poly_min_simd) ? poly_update<Word, M, Signed>::run(seed, p, n)
+                                                                             : poly_scalar<Word, M, Signed>(seed, p, n);
+                }
+            }
+
+#if defined(LIBCRYPT_X86_KERNELS)
+            template<std::size_t W, typename Offset, typename Kernel>
+            static void group(const std::uint8_t* bytes, const Offset* offsets, std::size_t rows,
+                              std::uint32_t* hashes, std::uint32_t seed, Kernel kernel){
+                const std::int64_t base = static_cast<std::int64_t>(offsets[0]);
+                if(static_cast<std::int64_t>(offsets[rows]) - base > std::numeric_limits<std::int32_t>::max() - 4)
+                    return serial(bytes, offsets, rows, hashes, seed);
+
+                // the tail word of a short row right at the start of the column would begin before bytes
+                if(base < 4){
+                    for(std::size_t l = 0; l < rows; ++l)
+                        if((offsets[l + 1] - offsets[l]) % 4 != 0 && static_cast<std::int64_t>(offsets[l + 1]) < 4)
+                            return serial(bytes, offsets, rows, hashes, seed);
+                }
+
+                // row l is [bounds[l], bounds[l + 1]), the lanes past rows are empty
+                alignas(64) std::int32_t bounds[W + 1];
+                alignas(64) std::uint32_t out[W];
+                for(std::size_t l = 0; l <= rows; ++l)
+                    bounds[l] = static_cast<std::int32_t>(static_cast<std::int64_t>(offsets[l]) - base);
+                for(std::size_t l = rows + 1; l <= W; ++l)
+                    bounds[l] = bounds[rows];
+
+                const unsigned long_rows = kernel(bytes + base, bounds, seed, out);
+                std::memcpy(hashes, out, rows * sizeof(std::uint32_t));
+                for(std::size_t l = 0; l < rows; ++l)
+                    if(long_rows >> l & 1)
+                        serial(bytes, offsets + l, 1, hashes + l, seed);
+            }
+#endif
+
+            template<typename Offset>
+            LIBCRYPT_NOINLINE static void run(const std::uint8_t* bytes, const Offset* offsets, std::size_t rows,
+                                              Word* hashes, Word seed){
+#if defined(LIBCRYPT_X86_KERNELS)
+                if constexpr(std::is_same_v<Word, std::uint32_t>){
+                    if(cpu::avx512f()){
+                        for(; rows != 0; ){
+                            const std::size_t n = std::min<std::size_t>(rows, 16);
+                            group<16>(bytes, offsets, n, hashes, seed, poly_column_avx512<M, Signed>);
+                            offsets += n;
+                            hashes += n;
+                            rows -= n;
+                        }
+                        return;
+                    }
+                    if(cpu::avx2()){
+                        for(; rows != 0; ){
+                            const std::size_t n = std::min<std::size_t>(rows, 8);
+                            group<8>(bytes, offsets, n, hashes, seed, poly_column_avx2<M, Signed>);
+                            offsets += n;
+                            hashes += n;
+                            rows -= n;
+                        }
+                        return;
+                    }
+                }
+#endif
+                serial(bytes, offsets, rows, hashes, seed);
+            }
+        };
+    }
+}
+
+#endif /* LIBCRYPT_POLY_SIMD_HPP */
@@ -34,92 +34,198 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "impl.hpp"
+#include "instrument.hpp"
+#include "sha_ni.hpp"
 
 namespace crypt{
-    class sha1{
-        std::array<std::uint8_t, 64> data;
-        std::uint32_t datalen;
-        std::uint64_t bitlen;
-        std::array<std::uint32_t, 5> state;
-        inline constexpr static std::array<std::uint32_t, 4> k{
+    namespace impl{
+        inline constexpr std::array<std::uint32_t, 4> sha1_k{
             0x5a827999,
             0x6ed9eba1,
             0x8f1bbcdc,
             0xca62c1d6
         };
 
-        void transform(){
-            std::array<std::uint32_t, 80> m;
-            std::uint32_t a, b, c, d, e, i, j, t;
-
-            for(i = 0, j = 0; i < 16; ++i, j += 4)
-                m[i] = static_cast<std::uint32_t>((data[j]     << 24) +
-                                                  (data[j + 1] << 16) +
-                                                  (data[j + 2] <<  8) +
-                                                  (data[j + 3]      )   );
-            for(; i < 80; ++i){
-                m[i] = (m[i - 3] ^ m[i - 8] ^ m[i - 14] ^ m[i - 16]);
-                m[i] = (m[i] << 1) | (m[i] >> 31);
+        /**
+         * Round I of sha1 on the working variables s with the message
+         * schedule kept in a ring of 16 words. As with sha2_round() the roles
+         * of the variables rotate through s instead of being moved.
+         */
+        template<std::size_t I>
+        LIBCRYPT_FORCE_INLINE constexpr void sha1_round(std::uint32_t (&s)[5], std::uint32_t (&w)[16]){
+            const std::uint32_t a = s[(5 - I % 5) % 5];
+            std::uint32_t& b      = s[(6 - I % 5) % 5];
+            const std::uint32_t c = s[(7 - I % 5) % 5];
+            const std::uint32_t d = s[(8 - I % 5) % 5];
+            std::uint32_t& e      = s[(9 - I % 5) % 5];
+
+            if constexpr(I >= 16)
+                w[I % 16] = ROTLEFT(w[(I - 3) % 16] ^ w[(I - 8) % 16] ^ w[(I - 14) % 16] ^ w[I % 16], 1);
+
+            std::uint32_t f = b ^ c ^ d;
+            if constexpr(I < 20)
+                f = CH(b, c, d);
+            else if constexpr(I >= 40 && I < 60)
+                f = MAJ(b, c, d);
+
+            e += ROTLEFT(a, 5) + f + sha1_k[I / 20] + w[I % 16];
+            b = ROTLEFT(b, 30);
+        }
+
+        template<std::size_t... I>
+        LIBCRYPT_FORCE_INLINE constexpr void sha1_rounds(std::uint32_t (&s)[5], std::uint32_t (&w)[16],
+                                                         std::index_sequence<I...>){
+            (sha1_round<I>(s, w), ...);
+        }
+
+        // the same rounds as one loop for policy::compact, the variables are moved
+        LIBCRYPT_FORCE_INLINE constexpr void sha1_rounds_rolled(std::uint32_t (&s)[5], std::uint32_t (&w)[16]){
+            for(std::size_t i = 0; i < 80; ++i){
+                if(i >= 16)
+                    w[i % 16] = ROTLEFT(w[(i - 3) % 16] ^ w[(i - 8) % 16] ^ w[(i - 14) % 16] ^ w[i % 16], 1);
+
+                std::uint32_t f = s[1] ^ s[2] ^ s[3];
+                if(i < 20)
+                    f = CH(s[1], s[2], s[3]);
+                else if(i >= 40 && i < 60)
+                    f = MAJ(s[1], s[2], s[3]);
+
+                const std::uint32_t t = ROTLEFT(s[0], 5) + f + s[4] + sha1_k[i / 20] + w[i % 16];
+                s[4] = s[3];
+                s[3] = s[2];
+                s[2] = ROTLEFT(s[1], 30);
+                s[1] = s[0];
+                s[0] = t;
             }
+        }
+    }
 
-            a = state[0];
-            b = state[1];
-            c = state[2];
-            d = state[3];
-            e = state[4];
-
-            {
-                using impl::ROTLEFT;
-                for(i = 0; i < 20; ++i){
-                    t = ROTLEFT(a, 5) + ((b & c) ^ (~b & d)) + e + k[0] + m[i];
-                    e = d;
-                    d = c;
-                    c = ROTLEFT(b, 30);
-                    b = a;
-                    a = t;
-                }
-                for(; i < 40; ++i){
-                    t = ROTLEFT(a, 5) + (b ^ c ^ d) + e + k[1] + m[i];
-                    e = d;
-                    d = c;
-                    c = ROTLEFT(b, 30);
-                    b = a;
-                    a = t;
-                }
-                for(; i < 60; ++i){
-                    t = ROTLEFT(a, 5) + ((b & c) ^ (b & d) ^ (c & d))  + e + k[2] + m[i];
-                    e = d;
-                    d = c;
-                    c = ROTLEFT(b, 30);
-                    b = a;
-                    a = t;
-                }
-                for(; i < 80; ++i){
-                    t = ROTLEFT(a, 5) + (b ^ c ^ d) + e + k[3] + m[i];
-                    e = d;
-                    d = c;
-                    c = ROTLEFT(b, 30);
-                    b = a;
-                    a = t;
-                }
+    template<typename Policy = policy::fast>
+    class basic_sha1{
+        std::array<std::uint8_t, 64> data{};
+        std::uint32_t datalen = 0;
+        std::uint64_t bitlen = 0;
+        std::array<std::uint32_t, 5> state{};
+        static constexpr instrument::algorithm probe_id = instrument::algorithm::sha1;
+
+        LIBCRYPT_NOINLINE static constexpr void transform_scalar(std::array<std::uint32_t, 5>& chain, const std::uint8_t* block){
+            std::uint32_t w[16] = {};
+            for(std::size_t i = 0, j = 0; i < 16; ++i, j += 4)
+                w[i] = static_cast<std::uint32_t>((block[j]     << 24) +
+                                                  (block[j + 1] << 16) +
+                                                  (block[j + 2] <<  8) +
+                                                  (block[j + 3]      )   );
+
+            // fully unrolled for policy::fast, the schedule is computed in place of the 16 word ring
+            std::uint32_t s[5] = {chain[0], chain[1], chain[2], chain[3], chain[4]};
+            if constexpr(std::is_same_v<Policy, policy::compact>)
+                impl::sha1_rounds_rolled(s, w);
+            else
+                impl::sha1_rounds(s, w, std::make_index_sequence<80>{});
+
+            for(std::size_t i = 0; i < 5; ++i)
+                chain[i] += s[i];
+        }
+
+        using transform_fn = void(std::array<std::uint32_t, 5>&, const std::uint8_t*, std::size_t);
+
+        // in order of preference, the last one runs everywhere
+        inline constexpr static impl::kernel<transform_fn> transform_kernels[] = {
+#if defined(LIBCRYPT_X86_KERNELS)
+            {"sha-ni", impl::cpu::sha_ni, [](std::array<std::uint32_t, 5>& chain, const std::uint8_t* block, std::size_t blocks){
+                impl::sha1_transform_shani(chain.data(), block, blocks);
+            }},
+#endif
+            {"scalar", impl::cpu::portable, [](std::array<std::uint32_t, 5>& chain, const std::uint8_t* block, std::size_t blocks){
+                for(; blocks != 0; --blocks, block += 64)
+                    transform_scalar(chain, block);
+            }}
+        };
+        inline static impl::dispatch<transform_fn> transform_dispatch{transform_kernels};
+
+        LIBCRYPT_NOINLINE static constexpr void transform(std::array<std::uint32_t, 5>& chain, const std::uint8_t* block, std::size_t blocks = 1){
+            if(!impl::is_constant_evaluated()){
+                std::uint64_t sample = impl::probe::transform_begin(probe_id, blocks);
+                transform_dispatch.active().entry(chain, block, blocks);
+                impl::probe::transform_end(probe_id, blocks, sample);
+                return;
+            }
+            for(; blocks != 0; --blocks, block += block_size)
+                transform_scalar(chain, block);
+        }
+
+        // one byte into the buffer, compressed once the block is full
+        constexpr void append(std::uint8_t byte){
+            data[datalen] = byte;
+            datalen++;
+            if(datalen == data.size()){
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 512;
+                datalen = 0;
+            }
+        }
+
+        // Fill the partially buffered block once, transform every full block
+        // straight from the input and buffer only the remaining tail.
+        void absorb(const std::uint8_t* first, std::size_t len){
+            if(datalen != 0){
+                std::size_t fill = data.size() - datalen;
+                if(fill > len)
+                    fill = len;
+                std::memcpy(data.data() + datalen, first, fill);
+                datalen += static_cast<std::uint32_t>(fill);
+                first += fill;
+                len -= fill;
+                if(datalen != data.size())
+                    return;
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 512;
+                datalen = 0;
             }
+            if(len >= data.size()){
+                const std::size_t blocks = len / data.size();
+                transform(state, first, blocks);
+                bitlen += 512 * static_cast<std::uint64_t>(blocks);
+                first += blocks * data.size();
+                len -= blocks * data.size();
+            }
+            std::memcpy(data.data(), first, len);
+            datalen = static_cast<std::uint32_t>(len);
+        }
 
-            state[0] += a;
-            state[1] += b;
-            state[2] += c;
-            state[3] += d;
-            state[4] += e;
+        // update() over a contiguous range, counted and timed as one call
+        void update_contiguous(const std::uint8_t* first, std::size_t len){
+            std::uint64_t sample = impl::probe::call_begin();
+            absorb(first, len);
+            impl::probe::update(probe_id, len, sample);
         }
 
     public:
-        sha1(){
+        using digest_type = std::array<std::uint8_t, 20>;
+        using midstate_type = crypt::midstate<std::uint32_t, 5>;
+        static constexpr std::size_t block_size = 64;
+        static constexpr std::size_t digest_size = 20;
+        static constexpr bool big_endian = true;    // byte order of the digest and length words
+
+        // name of the compression kernel selected for this CPU and the current cap
+        static const char* kernel(){
+            return transform_dispatch.active().name;
+        }
+
+        constexpr basic_sha1(){
             reset();
         }
 
-        void reset(){
+        constexpr void reset(){
             datalen = 0;
             bitlen = 0;
             state[0] = 0x67452301;
@@ -129,30 +235,83 @@ namespace crypt{
             state[4] = 0xc3d2e1f0;
         }
 
+        /**
+         * Resume from a chaining state exported at a block boundary, e.g. a
+         * shared prefix that was compressed once.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr explicit basic_sha1(const midstate_type& mid){
+            import_midstate(mid);
+        }
+
+        // true if no partial block is buffered and the state can be exported
+        constexpr bool block_aligned() const{
+            return datalen == 0;
+        }
+
+        /**
+         * The chaining state and the number of bits hashed so far. Only
+         * defined at a block boundary, throws std::logic_error while a
+         * partial block is buffered.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr midstate_type export_midstate() const{
+            if(datalen != 0)
+                impl::midstate_error::unaligned("crypt::sha1::export_midstate: not at a block boundary");
+            return midstate_type{state, bitlen};
+        }
+
+        LIBCRYPT_FORCE_INLINE constexpr void import_midstate(const midstate_type& mid){
+            if(mid.bitlen % 512 != 0)
+                impl::midstate_error::invalid("crypt::sha1::import_midstate: not at a block boundary");
+            datalen = 0;
+            bitlen = mid.bitlen;
+            state = mid.state;
+        }
+
+        // an independent copy, including a buffered partial block
+        constexpr basic_sha1 fork() const{
+            return *this;
+        }
+
+        /**
+         * Compress count whole blocks into mid, without buffering or
+         * padding. The building block for hashing many suffixes after one
+         * shared prefix.
+         */
+        static constexpr void compress(midstate_type& mid, const std::uint8_t* blocks, std::size_t count){
+            transform(mid.state, blocks, count);
+            mid.bitlen += 512 * static_cast<std::uint64_t>(count);
+        }
+
         template<typename T>
-        void update(const T& byte){
+        LIBCRYPT_FORCE_INLINE constexpr void update(const T& byte){
             static_assert((sizeof(T) == 1),
                           "crypt::sha1::update: T must be byte");
-            data[datalen] = static_cast<std::uint8_t>(byte);
-            datalen++;
-            if(datalen == data.size()){
-                transform();
-                bitlen += 512;
-                datalen = 0;
-            }
+            impl::probe::update(probe_id, 1);
+            append(static_cast<std::uint8_t>(byte));
         }
 
         template<typename Iterator>
-        void update(Iterator first, Iterator last){
+        constexpr void update(Iterator first, Iterator last){
             static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
                           "crypt::sha1::update: T::value_type must be byte");
-            for(; first != last; ++first){
-                update(*first);
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(!impl::is_constant_evaluated()){
+                    if(first != last)
+                        update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first),
+                                          static_cast<std::size_t>(last - first));
+                    return;
+                }
             }
+            std::uint64_t sample = impl::probe::call_begin();
+            std::size_t count = 0;
+            for(; first != last; ++first, ++count)
+                append(static_cast<std::uint8_t>(*first));
+            impl::probe::update(probe_id, count, sample);
         }
 
-        std::array<std::uint8_t, 20> final(){
-            std::array<std::uint8_t, 20> hash;
+        LIBCRYPT_NOINLINE constexpr std::array<std::uint8_t, 20> final(){
+            std::uint64_t sample = impl::probe::call_begin();
+            std::array<std::uint8_t, 20> hash{};
             std::uint32_t i = datalen;
 
             // Pad whatever data is left in the buffer.
@@ -164,7 +323,7 @@ namespace crypt{
                 data[i++] = 0x80;
                 while(i < 64)
                     data[i++] = 0x00;
-                transform();
+                transform(state, data.data());
                 for(std::size_t j = 0; j < 56; j++)
                     data[j] = 0;
             }
@@ -179,7 +338,7 @@ namespace crypt{
             data[58] = static_cast<std::uint8_t>(bitlen >> 40);
             data[57] = static_cast<std::uint8_t>(bitlen >> 48);
             data[56] = static_cast<std::uint8_t>(bitlen >> 56);
-            transform();
+            transform(state, data.data());
 
             // Since this implementation uses little endian byte ordering and MD uses big endian,
             // reverse all the bytes when copying the final state to the output hash.
@@ -191,9 +350,24 @@ namespace crypt{
                 hash[i + 16] = (state[4] >> (24 - i * 8)) & 0x000000ff;
             }
 
+            impl::probe::final(probe_id, sample);
             return hash;
         }
+
+        // digest of [first, last), usable in constant expressions
+        template<typename Iterator>
+        static constexpr std::array<std::uint8_t, 20> hash(Iterator first, Iterator last){
+            basic_sha1 algo;
+            algo.update(first, last);
+            return algo.final();
+        }
+
+        static constexpr std::array<std::uint8_t, 20> hash(std::string_view str){
+            return hash(str.begin(), str.end());
+        }
     };
+
+    using sha1 = basic_sha1<policy::fast>;
 }
 
 #endif /* LIBCRYPT_SHA1_HPP */
@@ -34,16 +34,25 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "impl.hpp"
+#include "instrument.hpp"
+#include "sha256_simd.hpp"
+#include "sha_ni.hpp"
 
 namespace crypt{
-    class sha224{
-        std::array<std::uint8_t, 64> data;
-        std::uint32_t datalen;
-        std::uint64_t bitlen;
-        std::array<std::uint32_t, 8> state;
+    template<typename Policy = policy::fast>
+    class basic_sha224{
+        std::array<std::uint8_t, 64> data{};
+        std::uint32_t datalen = 0;
+        std::uint64_t bitlen = 0;
+        std::array<std::uint32_t, 8> state{};
+        static constexpr instrument::algorithm probe_id = instrument::algorithm::sha224;
         inline constexpr static std::array<std::uint32_t, 64> k{
             0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
             0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
@@ -55,57 +64,147 @@ namespace crypt{
             0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
         };
 
-        void transform(){
-            using namespace impl;
-            std::array<std::uint32_t, 64> m;
-            std::uint32_t a, b, c, d, e, f, g, h, i, j, t1, t2;
-
-            for(i = 0, j = 0; i < 16; ++i, j += 4)
-                m[i] = static_cast<std::uint32_t>((data[j]     << 24) |
-                                                  (data[j + 1] << 16) |
-                                                  (data[j + 2] <<  8) |
-                                                  (data[j + 3]      )   );
-            for(; i < 64; ++i)
-                m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
-
-            a = state[0];
-            b = state[1];
-            c = state[2];
-            d = state[3];
-            e = state[4];
-            f = state[5];
-            g = state[6];
-            h = state[7];
-
-            for(i = 0; i < 64; ++i){
-                t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-                t2 = EP0(a) + MAJ(a,b,c);
-                h = g;
-                g = f;
-                f = e;
-                e = d + t1;
-                d = c;
-                c = b;
-                b = a;
-                a = t1 + t2;
+        LIBCRYPT_NOINLINE static constexpr void transform_scalar(std::array<std::uint32_t, 8>& chain, const std::uint8_t* block){
+            std::uint32_t w[16] = {};
+            for(std::size_t i = 0, j = 0; i < 16; ++i, j += 4)
+                w[i] = static_cast<std::uint32_t>((block[j]     << 24) |
+                                                  (block[j + 1] << 16) |
+                                                  (block[j + 2] <<  8) |
+                                                  (block[j + 3]      )   );
+
+            // fully unrolled for policy::fast, the schedule is computed in place of the 16 word ring
+            std::uint32_t s[8] = {chain[0], chain[1], chain[2], chain[3],
+                                  chain[4], chain[5], chain[6], chain[7]};
+            if constexpr(std::is_same_v<Policy, policy::compact>)
+                impl::sha2_rounds_rolled(s, w, k.data(), 64);
+            else
+                impl::sha2_rounds(s, w, k.data(), std::make_index_sequence<64>{});
+
+            for(std::size_t i = 0; i < 8; ++i)
+                chain[i] += s[i];
+        }
+
+        using transform_fn = void(std::array<std::uint32_t, 8>&, const std::uint8_t*, std::size_t);
+
+        // in order of preference, the last one runs everywhere
+        inline constexpr static impl::kernel<transform_fn> transform_kernels[] = {
+#if defined(LIBCRYPT_X86_KERNELS)
+            {"sha-ni", impl::cpu::sha_ni, [](std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks){
+                impl::sha256_transform_shani(chain.data(), k.data(), block, blocks);
+            }},
+            {"avx2", impl::cpu::avx2_bmi2, [](std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks){
+                impl::sha256_transform_avx2(chain.data(), k.data(), block, blocks);
+            }},
+            {"ssse3", impl::cpu::ssse3, [](std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks){
+                impl::sha256_transform_ssse3(chain.data(), k.data(), block, blocks);
+            }},
+#endif
+            {"scalar", impl::cpu::portable, [](std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks){
+                for(; blocks != 0; --blocks, block += 64)
+                    transform_scalar(chain, block);
+            }}
+        };
+
+        // policy::compact keeps the SHA-NI kernel, it is smaller than the rolled rounds
+        inline constexpr static impl::kernel<transform_fn> compact_kernels[] = {
+#if defined(LIBCRYPT_X86_KERNELS)
+            {"sha-ni", impl::cpu::sha_ni, [](std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks){
+                impl::sha256_transform_shani(chain.data(), k.data(), block, blocks);
+            }},
+#endif
+            {"scalar", impl::cpu::portable, [](std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks){
+                for(; blocks != 0; --blocks, block += 64)
+                    transform_scalar(chain, block);
+            }}
+        };
+
+        // only the table of the selected policy is instantiated
+        LIBCRYPT_FORCE_INLINE static impl::dispatch<transform_fn>& transform_dispatch(){
+            if constexpr(std::is_same_v<Policy, policy::compact>){
+                static impl::dispatch<transform_fn> compact{compact_kernels};
+                return compact;
+            }else{
+                static impl::dispatch<transform_fn> fast{transform_kernels};
+                return fast;
             }
+        }
+
+        LIBCRYPT_NOINLINE static constexpr void transform(std::array<std::uint32_t, 8>& chain, const std::uint8_t* block, std::size_t blocks = 1){
+            if(!impl::is_constant_evaluated()){
+                std::uint64_t sample = impl::probe::transform_begin(probe_id, blocks);
+                transform_dispatch().active().entry(chain, block, blocks);
+                impl::probe::transform_end(probe_id, blocks, sample);
+                return;
+            }
+            for(; blocks != 0; --blocks, block += block_size)
+                transform_scalar(chain, block);
+        }
+
+        // one byte into the buffer, compressed once the block is full
+        constexpr void append(std::uint8_t byte){
+            data[datalen] = byte;
+            datalen++;
+            if(datalen == data.size()){
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 512;
+                datalen = 0;
+            }
+        }
+
+        // Fill the partially buffered block once, transform every full block
+        // straight from the input and buffer only the remaining tail.
+        void absorb(const std::uint8_t* first, std::size_t len){
+            if(datalen != 0){
+                std::size_t fill = data.size() - datalen;
+                if(fill > len)
+                    fill = len;
+                std::memcpy(data.data() + datalen, first, fill);
+                datalen += static_cast<std::uint32_t>(fill);
+                first += fill;
+                len -= fill;
+                if(datalen != data.size())
+                    return;
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 512;
+                datalen = 0;
+            }
+            if(len >= data.size()){
+                const std::size_t blocks = len / data.size();
+                transform(state, first, blocks);
+                bitlen += 512 * static_cast<std::uint64_t>(blocks);
+                first += blocks * data.size();
+                len -= blocks * data.size();
+            }
+            std::memcpy(data.data(), first, len);
+            datalen = static_cast<std::uint32_t>(len);
+        }
 
-            state[0] += a;
-            state[1] += b;
-            state[2] += c;
-            state[3] += d;
-            state[4] += e;
-            state[5] += f;
-            state[6] += g;
-            state[7] += h;
+        // update() over a contiguous range, counted and timed as one call
+        void update_contiguous(const std::uint8_t* first, std::size_t len){
+            std::uint64_t sample = impl::probe::call_begin();
+            absorb(first, len);
+            impl::probe::update(probe_id, len, sample);
         }
 
     public:
-        sha224(){
+        using digest_type = std::array<std::uint8_t, 28>;
+        using midstate_type = crypt::midstate<std::uint32_t, 8>;
+        static constexpr std::size_t block_size = 64;
+        static constexpr std::size_t digest_size = 28;
+        static constexpr bool big_endian = true;    // byte order of the digest and length words
+
+        // name of the compression kernel selected for this CPU and the current cap
+        static const char* kernel(){
+            return transform_dispatch().active().name;
+        }
+
+        constexpr basic_sha224(){
             reset();
         }
 
-        void reset(){
+        constexpr void reset(){
             datalen = 0;
             bitlen = 0;
             state[0] = 0xc1059ed8;
@@ -118,30 +217,83 @@ namespace crypt{
             state[7] = 0xbefa4fa4;
         }
 
+        /**
+         * Resume from a chaining state exported at a block boundary, e.g. a
+         * shared prefix that was compressed once.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr explicit basic_sha224(const midstate_type& mid){
+            import_midstate(mid);
+        }
+
+        // true if no partial block is buffered and the state can be exported
+        constexpr bool block_aligned() const{
+            return datalen == 0;
+        }
+
+        /**
+         * The chaining state and the number of bits hashed so far. Only
+         * defined at a block boundary, throws std::logic_error while a
+         * partial block is buffered.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr midstate_type export_midstate() const{
+            if(datalen != 0)
+                impl::midstate_error::unaligned("crypt::sha224::export_midstate: not at a block boundary");
+            return midstate_type{state, bitlen};
+        }
+
+        LIBCRYPT_FORCE_INLINE constexpr void import_midstate(const midstate_type& mid){
+            if(mid.bitlen % 512 != 0)
+                impl::midstate_error::invalid("crypt::sha224::import_midstate: not at a block boundary");
+            datalen = 0;
+            bitlen = mid.bitlen;
+            state = mid.state;
+        }
+
+        // an independent copy, including a buffered partial block
+        constexpr basic_sha224 fork() const{
+            return *this;
+        }
+
+        /**
+         * Compress count whole blocks into mid, without buffering or
+         * padding. The building block for hashing many suffixes after one
+         * shared prefix.
+         */
+        static constexpr void compress(midstate_type& mid, const std::uint8_t* blocks, std::size_t count){
+            transform(mid.state, blocks, count);
+            mid.bitlen += 512 * static_cast<std::uint64_t>(count);
+        }
+
         template<typename T>
-        void update(const T& byte){
+        LIBCRYPT_FORCE_INLINE constexpr void update(const T& byte){
             static_assert((sizeof(T) == 1),
                           "crypt::sha224::update: T must be byte");
-            data[datalen] = static_cast<std::uint8_t>(byte);
-            datalen++;
-            if(datalen == data.size()){
-                transform();
-                bitlen += 512;
-                datalen = 0;
-            }
+            impl::probe::update(probe_id, 1);
+            append(static_cast<std::uint8_t>(byte));
         }
 
         template<typename Iterator>
-        void update(Iterator first, Iterator last){
+        constexpr void update(Iterator first, Iterator last){
             static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
                           "crypt::sha224::update: T::value_type must be byte");
-            for(; first != last; ++first){
-                update(*first);
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(!impl::is_constant_evaluated()){
+                    if(first != last)
+                        update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first),
+                                          static_cast<std::size_t>(last - first));
+                    return;
+                }
             }
+            std::uint64_t sample = impl::probe::call_begin();
+            std::size_t count = 0;
+            for(; first != last; ++first, ++count)
+                append(static_cast<std::uint8_t>(*first));
+            impl::probe::update(probe_id, count, sample);
         }
 
-        std::array<std::uint8_t, 28> final(){
-            std::array<std::uint8_t, 28> hash;
+        LIBCRYPT_NOINLINE constexpr std::array<std::uint8_t, 28> final(){
+            std::uint64_t sample = impl::probe::call_begin();
+            std::array<std::uint8_t, 28> hash{};
             std::uint32_t i = datalen;
 
             // Pad whatever data is left in the buffer.
@@ -153,7 +305,7 @@ namespace crypt{
                 data[i++] = 0x80;
                 while(i < 64)
                     data[i++] = 0x00;
-                transform();
+                transform(state, data.data());
                 for(std::size_t j = 0; j < 56; j++)
                     data[j] = 0;
             }
@@ -168,7 +320,7 @@ namespace crypt{
             data[58] = static_cast<std::uint8_t>(bitlen >> 40);
             data[57] = static_cast<std::uint8_t>(bitlen >> 48);
             data[56] = static_cast<std::uint8_t>(bitlen >> 56);
-            transform();
+            transform(state, data.data());
 
             // Since this implementation uses little endian byte ordering and SHA uses big endian,
             // reverse all the bytes when copying the final state to the output hash.
@@ -182,9 +334,24 @@ namespace crypt{
                 hash[i + 24] = (state[6] >> (24 - i * 8)) & 0x000000ff;
             }
 
+            impl::probe::final(probe_id, sample);
             return hash;
         }
+
+        // digest of [first, last), usable in constant expressions
+        template<typename Iterator>
+        static constexpr std::array<std::uint8_t, 28> hash(Iterator first, Iterator last){
+            basic_sha224 algo;
+            algo.update(first, last);
+            return algo.final();
+        }
+
+        static constexpr std::array<std::uint8_t, 28> hash(std::string_view str){
+            return hash(str.begin(), str.end());
+        }
     };
+
+    using sha224 = basic_sha224<policy::fast>;
 }
 
 #endif /* LIBCRYPT_SHA224_HPP */
@@ -0,0 +1,222 @@
+/**
+ * @file   libcrypt/include/sha256_mb.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  multi-buffer sha256 and sha224
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_SHA256_MB_HPP
+#define LIBCRYPT_SHA256_MB_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "impl.hpp"
+#include "multibuffer.hpp"
+#include "sha224.hpp"
+#include "sha256.hpp"
+
+namespace crypt{
+    namespace impl{
+        template<typename Hash>
+        struct sha256_mb_iv;
+
+        template<>
+        struct sha256_mb_iv<sha256>{
+            inline constexpr static std::array<std::uint32_t, 8> value{
+                0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+            };
+        };
+
+        template<>
+        struct sha256_mb_iv<sha224>{
+            inline constexpr static std::array<std::uint32_t, 8> value{
+                0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+                0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+            };
+        };
+
+#if defined(LIBCRYPT_X86_KERNELS)
+LIBCRYPT_MB_BEGIN
+        namespace mb{
+            // sha256 compression of one block per lane, same rounds as sha256::transform()
+            template<typename V>
+            LIBCRYPT_FORCE_INLINE void sha256_compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                constexpr std::size_t lanes = lanes_v<V>;
+                V w[16];
+                load_message<V, true>(w, blocks);
+
+                V a = load<V>(state + 0 * lanes);
+                V b = load<V>(state + 1 * lanes);
+                V c = load<V>(state + 2 * lanes);
+                V d = load<V>(state + 3 * lanes);
+                V e = load<V>(state + 4 * lanes);
+                V f = load<V>(state + 5 * lanes);
+                V g = load<V>(state + 6 * lanes);
+                V h = load<V>(state + 7 * lanes);
+
+                for(std::size_t i = 0; i < 64; ++i){
+                    if(i >= 16){
+                        const V& w2  = w[(i -  2) % 16];
+                        const V& w15 = w[(i - 15) % 16];
+                        const V s0 = LIBCRYPT_MB_ROTR(w15, 7) ^ LIBCRYPT_MB_ROTR(w15, 18) ^ (w15 >> 3);
+                        const V s1 = LIBCRYPT_MB_ROTR(w2, 17) ^ LIBCRYPT_MB_ROTR(w2, 19) ^ (w2 >> 10);
+                        w[i % 16] += s1 + w[(i - 7) % 16] + s0;
+                    }
+                    const V ep0 = LIBCRYPT_MB_ROTR(a, 2) ^ LIBCRYPT_MB_ROTR(a, 13) ^ LIBCRYPT_MB_ROTR(a, 22);
+                    const V ep1 = LIBCRYPT_MB_ROTR(e, 6) ^ LIBCRYPT_MB_ROTR(e, 11) ^ LIBCRYPT_MB_ROTR(e, 25);
+                    const V t1 = h + ep1 + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i % 16];
+                    const V t2 = ep0 + ((a & b) ^ (a & c) ^ (b & c));
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+
+                store(state + 0 * lanes, load<V>(state + 0 * lanes) + a);
+                store(state + 1 * lanes, load<V>(state + 1 * lanes) + b);
+                store(state + 2 * lanes, load<V>(state + 2 * lanes) + c);
+                store(state + 3 * lanes, load<V>(state + 3 * lanes) + d);
+                store(state + 4 * lanes, load<V>(state + 4 * lanes) + e);
+                store(state + 5 * lanes, load<V>(state + 5 * lanes) + f);
+                store(state + 6 * lanes, load<V>(state + 6 * lanes) + g);
+                store(state + 7 * lanes, load<V>(state + 7 * lanes) + h);
+            }
+        }
+LIBCRYPT_MB_END
+
+        template<typename Hash, std::size_t Lanes>
+        struct sha256_lanes{
+            inline constexpr static std::size_t lanes = Lanes;
+            inline constexpr static std::size_t words = 8;
+            inline constexpr static bool big_endian = true;
+            inline constexpr static const std::array<std::uint32_t, 8>& iv = sha256_mb_iv<Hash>::value;
+
+            static void digest(const std::uint32_t* state, std::size_t lane, std::uint8_t* out){
+                constexpr std::size_t digest_words = std::tuple_size_v<decltype(std::declval<Hash&>().final())> / 4;
+                for(std::size_t w = 0; w < digest_words; ++w){
+                    const std::uint32_t v = state[w * lanes + lane];
+                    out[w * 4]     = static_cast<std::uint8_t>(v >> 24);
+                    out[w * 4 + 1] = static_cast<std::uint8_t>(v >> 16);
+                    out[w * 4 + 2] = static_cast<std::uint8_t>(v >>  8);
+                    out[w * 4 + 3] = static_cast<std::uint8_t>(v);
+                }
+            }
+        };
+
+        template<typename Hash>
+        struct sha256_avx2 : sha256_lanes<Hash, 8>{
+            __attribute__((target("avx2"), noinline))
+            static void compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                mb::sha256_compress<mb::u32x8>(state, blocks);
+            }
+        };
+
+        template<typename Hash>
+        struct sha256_avx512 : sha256_lanes<Hash, 16>{
+            __attribute__((target("avx512f"), noinline))
+            static void compress(std::uint32_t* state, const std::uint8_t* const* blocks){
+                mb::sha256_compress<mb::u32x16>(state, blocks);
+            }
+        };
+#endif
+    }
+
+    /**
+     * Multi-buffer sha256/sha224: hashes many independent messages at once,
+     * one message per SIMD lane (8 lanes with AVX2, 16 with AVX-512).
+     *
+     * Otherwise every message is hashed on its own with Hash, the digests
+     * are the same either way.
+     */
+    template<typename Hash, std::size_t Lanes>
+    class sha256_mb{
+        static_assert(std::is_same_v<Hash, sha256> || std::is_same_v<Hash, sha224>,
+                      "crypt::sha256_mb: Hash must be sha256 or sha224");
+        static_assert(Lanes == 8 || Lanes == 16,
+                      "crypt::sha256_mb: Lanes must be 8 or 16");
+
+    public:
+        using digest_type = decltype(std::declval<Hash&>().final());
+        inline constexpr static std::size_t lanes = Lanes;
+
+        /**
+         * true if the lanes run in SIMD registers on this CPU. Eight AVX2 lanes
+         * are slower than hashing one message after the other with SHA-NI, so
+         * sha256_x8 only uses them on CPUs without the SHA extensions.
+         */
+        static bool accelerated(){
+#if defined(LIBCRYPT_X86_KERNELS)
+            if constexpr(Lanes == 8)
+                return impl::cpu::avx2() && !impl::cpu::sha_ni();
+            else
+                return impl::cpu::avx512f();
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Hash count messages, message i is lengths[i] bytes at messages[i]
+         * and its digest is written to digests[i].
+         */
+        static void hash(const std::uint8_t* const* messages, const std::size_t* lengths,
+                         std::size_t count, digest_type* digests){
+#if defined(LIBCRYPT_X86_KERNELS)
+            if(accelerated()){
+                using kernel = std::conditional_t<Lanes == 8,
+                                                  impl::sha256_avx2<Hash>,
+                                                  impl::sha256_avx512<Hash>>;
+                impl::mb::run<kernel>(messages, lengths, count, digests);
+                return;
+            }
+#endif
+            impl::mb::run_serial<Hash>(messages, lengths, count, digests);
+        }
+
+        // Hash every element of a range of contiguous byte containers.
+        template<typename Messages>
+        static std::vector<digest_type> hash(const Messages& messages){
+            return impl::mb::hash_range<sha256_mb>(messages);
+        }
+    };
+
+    using sha256_x8  = sha256_mb<sha256, 8>;
+    using sha256_x16 = sha256_mb<sha256, 16>;
+    using sha224_x8  = sha256_mb<sha224, 8>;
+    using sha224_x16 = sha256_mb<sha224, 16>;
+}
+
+#endif /* LIBCRYPT_SHA256_MB_HPP */
@@ -0,0 +1,231 @@
+/**
+ * @file   libcrypt/include/sha256_simd.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  single-stream sha256 kernels with SSSE3 and AVX2/BMI2
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_SHA256_SIMD_HPP
+#define LIBCRYPT_SHA256_SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "impl.hpp"
+
+#if defined(LIBCRYPT_X86_KERNELS)
+#include <immintrin.h>
+
+#define LIBCRYPT_SSSE3_TARGET __attribute__((target("ssse3"), always_inline))
+#define LIBCRYPT_AVX2_TARGET  __attribute__((target("avx2,bmi2"), always_inline))
+
+namespace crypt{
+    namespace impl{
+        namespace sha256_simd{
+            // rounds I... with W + K stored in groups of four words, Stride words apart
+            template<std::size_t Stride, std::size_t... I>
+            LIBCRYPT_FORCE_INLINE void rounds(std::uint32_t (&s)[8], const std::uint32_t* wk,
+                                              std::index_sequence<I...>){
+                (sha2_round<I>(s, wk[(I / 4) * Stride + I % 4]), ...);
+            }
+
+            // W[t..t+3] from x0 = W[t-16..t-13] up to x3 = W[t-4..t-1], in every 128 bit lane
+            LIBCRYPT_SSSE3_TARGET inline __m128i schedule(__m128i x0, __m128i x1, __m128i x2, __m128i x3){
+                const __m128i lo = _mm_set_epi8(-1,-1,-1,-1,-1,-1,-1,-1, 11,10,9,8, 3,2,1,0);
+                const __m128i hi = _mm_set_epi8(11,10,9,8, 3,2,1,0, -1,-1,-1,-1,-1,-1,-1,-1);
+
+                const __m128i w15 = _mm_alignr_epi8(x1, x0, 4);
+                const __m128i w7  = _mm_alignr_epi8(x3, x2, 4);
+                const __m128i s0  = _mm_xor_si128(
+                    _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(w15, 7), _mm_slli_epi32(w15, 25)),
+                                  _mm_xor_si128(_mm_srli_epi32(w15, 18), _mm_slli_epi32(w15, 14))),
+                    _mm_srli_epi32(w15, 3));
+                __m128i t = _mm_add_epi32(_mm_add_epi32(x0, w7), s0);
+
+                // SIG1 two words at a time, a duplicated word shifted by 64
+                // bits yields its 32 bit rotation in the low half
+                __m128i v = _mm_shuffle_epi32(x3, 0xfa);
+                __m128i s1 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi64(v, 17), _mm_srli_epi64(v, 19)),
+                                           _mm_srli_epi32(v, 10));
+                t = _mm_add_epi32(t, _mm_shuffle_epi8(s1, lo));
+
+                v = _mm_shuffle_epi32(t, 0x50);
+                s1 = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi64(v, 17), _mm_srli_epi64(v, 19)),
+                                   _mm_srli_epi32(v, 10));
+                return _mm_add_epi32(t, _mm_shuffle_epi8(s1, hi));
+            }
+
+            LIBCRYPT_AVX2_TARGET inline __m256i schedule(__m256i x0, __m256i x1, __m256i x2, __m256i x3){
+                const __m256i lo = _mm256_set_epi8(-1,-1,-1,-1,-1,-1,-1,-1, 11,10,9,8, 3,2,1,0,
+                                                   -1,-1,-1,-1,-1,-1,-1,-1, 11,10,9,8, 3,2,1,0);
+                const __m256i hi = _mm256_set_epi8(11,10,9,8, 3,2,1,0, -1,-1,-1,-1,-1,-1,-1,-1,
+                                                   11,10,9,8, 3,2,1,0, -1,-1,-1,-1,-1,-1,-1,-1);
+
+                const __m256i w15 = _mm256_alignr_epi8(x1, x0, 4);
+                const __m256i w7  = _mm256_alignr_epi8(x3, x2, 4);
+                const __m256i s0  = _mm256_xor_si256(
+                    _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi32(w15, 7), _mm256_slli_epi32(w15, 25)),
+                                     _mm256_xor_si256(_mm256_srli_epi32(w15, 18), _mm256_slli_epi32(w15, 14))),
+                    _mm256_srli_epi32(w15, 3));
+                __m256i t = _mm256_add_epi32(_mm256_add_epi32(x0, w7), s0);
+
+                __m256i v = _mm256_shuffle_epi32(x3, 0xfa);
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(v, 17), _mm256_srli_epi64(v, 19)),
+                                              _mm256_srli_epi32(v, 10));
+                t = _mm256_add_epi32(t, _mm256_shuffle_epi8(s1, lo));
+
+                v = _mm256_shuffle_epi32(t, 0x50);
+                s1 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(v, 17), _mm256_srli_epi64(v, 19)),
+                                      _mm256_srli_epi32(v, 10));
+                return _mm256_add_epi32(t, _mm256_shuffle_epi8(s1, hi));
+            }
+
+            // rounds of group G (four rounds) while the words of group G + 4 are scheduled
+            template<std::size_t G>
+            LIBCRYPT_SSSE3_TARGET inline void group(std::uint32_t (&s)[8], __m128i (&x)[4],
+                                                    std::uint32_t* wk, const std::uint32_t* k){
+                if constexpr(G < 12){
+                    __m128i& w = x[G % 4];
+                    w = schedule(w, x[(G + 1) % 4], x[(G + 2) % 4], x[(G + 3) % 4]);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(wk + (G + 4) * 4),
+                                    _mm_add_epi32(w, _mm_loadu_si128(reinterpret_cast<const __m128i*>(k + (G + 4) * 4))));
+                }
+                rounds<4>(s, wk, std::index_sequence<G * 4, G * 4 + 1, G * 4 + 2, G * 4 + 3>{});
+            }
+
+            template<std::size_t G>
+            LIBCRYPT_AVX2_TARGET inline void group(std::uint32_t (&s)[8], __m256i (&x)[4],
+                                                   std::uint32_t* wk, const __m256i* k){
+                if constexpr(G < 12){
+                    __m256i& w = x[G % 4];
+                    w = schedule(w, x[(G + 1) % 4], x[(G + 2) % 4], x[(G + 3) % 4]);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(wk + (G + 4) * 8),
+                                       _mm256_add_epi32(w, _mm256_loadu_si256(k + G + 4)));
+                }
+                rounds<8>(s, wk, std::index_sequence<G * 4, G * 4 + 1, G * 4 + 2, G * 4 + 3>{});
+            }
+
+            template<std::size_t... G>
+            LIBCRYPT_SSSE3_TARGET inline void groups(std::uint32_t (&s)[8], __m128i (&x)[4],
+                                                     std::uint32_t* wk, const std::uint32_t* k,
+                                                     std::index_sequence<G...>){
+                (group<G>(s, x, wk, k), ...);
+            }
+
+            template<std::size_t... G>
+            LIBCRYPT_AVX2_TARGET inline void groups(std::uint32_t (&s)[8], __m256i (&x)[4],
+                                                    std::uint32_t* wk, const __m256i* k,
+                                                    std::index_sequence<G...>){
+                (group<G>(s, x, wk, k), ...);
+            }
+
+            LIBCRYPT_FORCE_INLINE void add_state(std::uint32_t* state, const std::uint32_t (&s)[8]){
+                for(std::size_t i = 0; i < 8; ++i)
+                    state[i] += s[i];
+            }
+        }
+
+        /**
+         * sha256 compression of `blocks` consecutive 64 byte blocks, the
+         * message schedule is computed four words at a time with SSSE3 and
+         * overlaps the rounds of the previous four words.
+         */
+        __attribute__((target("ssse3"), noinline))
+        inline void sha256_transform_ssse3(std::uint32_t* state, const std::uint32_t* k,
+                                           const std::uint8_t* block, std::size_t blocks){
+            const __m128i bswap = _mm_set_epi8(12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3);
+
+            for(; blocks != 0; --blocks, block += 64){
+                alignas(16) std::uint32_t wk[64];
+                __m128i x[4];
+                for(std::size_t i = 0; i < 4; ++i){
+                    x[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16)), bswap);
+                    _mm_store_si128(reinterpret_cast<__m128i*>(wk + i * 4),
+                                    _mm_add_epi32(x[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(k + i * 4))));
+                }
+
+                std::uint32_t s[8] = {state[0], state[1], state[2], state[3],
+                                      state[4], state[5], state[6], state[7]};
+                sha256_simd::groups(s, x, wk, k, std::make_index_sequence<16>{});
+                sha256_simd::add_state(state, s);
+            }
+        }
+
+        /**
+         * sha256 compression with AVX2 and BMI2: two blocks share the 256 bit
+         * registers, one per 128 bit lane. The schedule of both is computed
+         * during the rounds of the first, the second then runs its rounds
+         * from the stored words. The rotations compile to rorx.
+         */
+        __attribute__((target("avx2,bmi2"), noinline))
+        inline void sha256_transform_avx2(std::uint32_t* state, const std::uint32_t* k,
+                                          const std::uint8_t* block, std::size_t blocks){
+            const __m256i bswap = _mm256_set_epi8(12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3,
+                                                  12,13,14,15, 8,9,10,11, 4,5,6,7, 0,1,2,3);
+            alignas(32) __m256i kk[16];
+            for(std::size_t i = 0; i < 16; ++i)
+                kk[i] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(k + i * 4)));
+
+            while(blocks != 0){
+                // an odd last block is loaded into both lanes, the second lane is dropped
+                const std::uint8_t* second = blocks > 1 ? block + 64 : block;
+
+                alignas(32) std::uint32_t wk[128];
+                __m256i x[4];
+                for(std::size_t i = 0; i < 4; ++i){
+                    const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i * 16));
+                    const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + i * 16));
+                    x[i] = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(b0), b1, 1), bswap);
+                    _mm256_store_si256(reinterpret_cast<__m256i*>(wk + i * 8), _mm256_add_epi32(x[i], kk[i]));
+                }
+
+                std::uint32_t s[8] = {state[0], state[1], state[2], state[3],
+                                      state[4], state[5], state[6], state[7]};
+                sha256_simd::groups(s, x, wk, kk, std::make_index_sequence<16>{});
+                sha256_simd::add_state(state, s);
+
+                if(blocks == 1)
+                    break;
+
+                std::uint32_t t[8] = {state[0], state[1], state[2], state[3],
+                                      state[4], state[5], state[6], state[7]};
+                sha256_simd::rounds<8>(t, wk + 4, std::make_index_sequence<64>{});
+                sha256_simd::add_state(state, t);
+
+                blocks -= 2;
+                block += 128;
+            }
+        }
+    }
+}
+
+#undef LIBCRYPT_SSSE3_TARGET
+#undef LIBCRYPT_AVX2_TARGET
+
+#endif /* LIBCRYPT_X86_KERNELS */
+
+#endif /* LIBCRYPT_SHA256_SIMD_HPP */
@@ -0,0 +1,339 @@
+/**
+ * @file   libcrypt/include/sha512.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  sha512 hash implementation
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_SHA512_HPP
+#define LIBCRYPT_SHA512_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "impl.hpp"
+#include "instrument.hpp"
+
+namespace crypt{
+    namespace impl{
+        inline constexpr std::array<std::uint64_t, 80> sha512_k{
+            0x428a2f98d728ae22,0x7137449123ef65cd,0xb5c0fbcfec4d3b2f,0xe9b5dba58189dbbc,
+            0x3956c25bf348b538,0x59f111f1b605d019,0x923f82a4af194f9b,0xab1c5ed5da6d8118,
+            0xd807aa98a3030242,0x12835b0145706fbe,0x243185be4ee4b28c,0x550c7dc3d5ffb4e2,
+            0x72be5d74f27b896f,0x80deb1fe3b1696b1,0x9bdc06a725c71235,0xc19bf174cf692694,
+            0xe49b69c19ef14ad2,0xefbe4786384f25e3,0x0fc19dc68b8cd5b5,0x240ca1cc77ac9c65,
+            0x2de92c6f592b0275,0x4a7484aa6ea6e483,0x5cb0a9dcbd41fbd4,0x76f988da831153b5,
+            0x983e5152ee66dfab,0xa831c66d2db43210,0xb00327c898fb213f,0xbf597fc7beef0ee4,
+            0xc6e00bf33da88fc2,0xd5a79147930aa725,0x06ca6351e003826f,0x142929670a0e6e70,
+            0x27b70a8546d22ffc,0x2e1b21385c26c926,0x4d2c6dfc5ac42aed,0x53380d139d95b3df,
+            0x650a73548baf63de,0x766a0abb3c77b2a8,0x81c2c92e47edaee6,0x92722c851482353b,
+            0xa2bfe8a14cf10364,0xa81a664bbc423001,0xc24b8b70d0f89791,0xc76c51a30654be30,
+            0xd192e819d6ef5218,0xd69906245565a910,0xf40e35855771202a,0x106aa07032bbd1b8,
+            0x19a4c116b8d2d0c8,0x1e376c085141ab53,0x2748774cdf8eeb99,0x34b0bcb5e19b48a8,
+            0x391c0cb3c5c95a63,0x4ed8aa4ae3418acb,0x5b9cca4f7763e373,0x682e6ff3d6b2b8a3,
+            0x748f82ee5defb2fc,0x78a5636f43172f60,0x84c87814a1f0ab72,0x8cc702081a6439ec,
+            0x90befffa23631e28,0xa4506cebde82bde9,0xbef9a3f7b2c67915,0xc67178f2e372532b,
+            0xca273eceea26619c,0xd186b8c721c0c207,0xeada7dd6cde0eb1e,0xf57d4f7fee6ed178,
+            0x06f067aa72176fba,0x0a637dc5a2c898a6,0x113f9804bef90dae,0x1b710b35131c471b,
+            0x28db77f523047d84,0x32caab7b40c72493,0x3c9ebe0a15c9bebc,0x431d67c49c100d4c,
+            0x4cc5d4becb3e42b6,0x597f299cfc657e2a,0x5fcb6fab3ad6faec,0x6c44198c4a475817
+        };
+
+        // initial hash values, selected by digest size
+        template<std::size_t DigestSize>
+        struct sha512_iv;
+
+        template<>
+        struct sha512_iv<64>{
+            static constexpr std::array<std::uint64_t, 8> value{
+                0x6a09e667f3bcc908,0xbb67ae8584caa73b,0x3c6ef372fe94f82b,0xa54ff53a5f1d36f1,
+                0x510e527fade682d1,0x9b05688c2b3e6c1f,0x1f83d9abfb41bd6b,0x5be0cd19137e2179
+            };
+        };
+
+        template<>
+        struct sha512_iv<48>{
+            static constexpr std::array<std::uint64_t, 8> value{
+                0xcbbb9d5dc1059ed8,0x629a292a367cd507,0x9159015a3070dd17,0x152fecd8f70e5939,
+                0x67332667ffc00b31,0x8eb44a8768581511,0xdb0c2e0d64f98fa7,0x47b5481dbefa4fa4
+            };
+        };
+
+        template<>
+        struct sha512_iv<32>{
+            static constexpr std::array<std::uint64_t, 8> value{
+                0x22312194fc2bf72c,0x9f555fa3c84c64c2,0x2393b86b6f53b151,0x963877195940eabd,
+                0x96283ee2a88effe3,0xbe5e1e2553863992,0x2b0199fc2c85b8aa,0x0eb72ddc81c52ca2
+            };
+        };
+
+        template<>
+        struct sha512_iv<28>{
+            static constexpr std::array<std::uint64_t, 8> value{
+                0x8c3d37c819544da2,0x73e1996689dcd4d6,0x1dfab7ae32ff9c82,0x679dd514582f9fcf,
+                0x0f6d2b697bd44da8,0x77e36f7304c48942,0x3f9d85a86a1d36c8,0x1112e6ad91d692a1
+            };
+        };
+    }
+
+    /**
+     * SHA-512 and its truncated variants: sha512 (64 byte digest), sha384
+     * (48), sha512_256 (32) and sha512_224 (28) share the 64-bit transform
+     * and the 128 byte block and differ in initial values and digest size.
+     */
+    template<std::size_t DigestSize>
+    class basic_sha512{
+        std::array<std::uint8_t, 128> data{};
+        std::uint32_t datalen = 0;
+        std::uint64_t bitlen = 0;
+        std::array<std::uint64_t, 8> state{};
+
+        static constexpr instrument::algorithm probe_id =
+            DigestSize == 64 ? instrument::algorithm::sha512     :
+            DigestSize == 48 ? instrument::algorithm::sha384     :
+            DigestSize == 32 ? instrument::algorithm::sha512_256 :
+                               instrument::algorithm::sha512_224;
+
+        LIBCRYPT_NOINLINE static constexpr void transform(std::array<std::uint64_t, 8>& chain, const std::uint8_t* block, std::size_t blocks = 1){
+            std::uint64_t sample = impl::probe::transform_begin(probe_id, blocks);
+            for(std::size_t n = blocks; n != 0; --n, block += block_size){
+                std::uint64_t w[16] = {};
+                for(std::size_t i = 0, j = 0; i < 16; ++i, j += 8)
+                    w[i] = (static_cast<std::uint64_t>(block[j    ]) << 56) |
+                           (static_cast<std::uint64_t>(block[j + 1]) << 48) |
+                           (static_cast<std::uint64_t>(block[j + 2]) << 40) |
+                           (static_cast<std::uint64_t>(block[j + 3]) << 32) |
+                           (static_cast<std::uint64_t>(block[j + 4]) << 24) |
+                           (static_cast<std::uint64_t>(block[j + 5]) << 16) |
+                           (static_cast<std::uint64_t>(block[j + 6]) <<  8) |
+                           (static_cast<std::uint64_t>(block[j + 7])      );
+
+                std::uint64_t s[8] = {chain[0], chain[1], chain[2], chain[3],
+                                      chain[4], chain[5], chain[6], chain[7]};
+                impl::sha2_rounds(s, w, impl::sha512_k.data(), std::make_index_sequence<80>{});
+
+                for(std::size_t i = 0; i < 8; ++i)
+                    chain[i] += s[i];
+            }
+            impl::probe::transform_end(probe_id, blocks, sample);
+        }
+
+        // one byte into the buffer, compressed once the block is full
+        constexpr void append(std::uint8_t byte){
+            data[datalen] = byte;
+            datalen++;
+            if(datalen == data.size()){
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 1024;
+                datalen = 0;
+            }
+        }
+
+        // Fill the partially buffered block once, transform every full block
+        // straight from the input and buffer only the remaining tail.
+        void absorb(const std::uint8_t* first, std::size_t len){
+            if(datalen != 0){
+                std::size_t fill = data.size() - datalen;
+                if(fill > len)
+                    fill = len;
+                std::memcpy(data.data() + datalen, first, fill);
+                datalen += static_cast<std::uint32_t>(fill);
+                first += fill;
+                len -= fill;
+                if(datalen != data.size())
+                    return;
+                impl::probe::flush(probe_id);
+                transform(state, data.data());
+                bitlen += 1024;
+                datalen = 0;
+            }
+            if(len >= data.size()){
+                const std::size_t blocks = len / data.size();
+                transform(state, first, blocks);
+                bitlen += 1024 * static_cast<std::uint64_t>(blocks);
+                first += blocks * data.size();
+                len -= blocks * data.size();
+            }
+            std::memcpy(data.data(), first, len);
+            datalen = static_cast<std::uint32_t>(len);
+        }
+
+        // update() over a contiguous range, counted and timed as one call
+        void update_contiguous(const std::uint8_t* first, std::size_t len){
+            std::uint64_t sample = impl::probe::call_begin();
+            absorb(first, len);
+            impl::probe::update(probe_id, len, sample);
+        }
+
+    public:
+        using digest_type = std::array<std::uint8_t, DigestSize>;
+        using midstate_type = crypt::midstate<std::uint64_t, 8>;
+        static constexpr std::size_t block_size = 128;
+        static constexpr std::size_t digest_size = DigestSize;
+        static constexpr bool big_endian = true;    // byte order of the digest and length words
+
+        constexpr basic_sha512(){
+            reset();
+        }
+
+        constexpr void reset(){
+            datalen = 0;
+            bitlen = 0;
+            for(std::size_t i = 0; i < state.size(); i++)
+                state[i] = impl::sha512_iv<DigestSize>::value[i];
+        }
+
+        /**
+         * Resume from a chaining state exported at a block boundary, e.g. a
+         * shared prefix that was compressed once.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr explicit basic_sha512(const midstate_type& mid){
+            import_midstate(mid);
+        }
+
+        // true if no partial block is buffered and the state can be exported
+        constexpr bool block_aligned() const{
+            return datalen == 0;
+        }
+
+        /**
+         * The chaining state and the number of bits hashed so far. Only
+         * defined at a block boundary, throws std::logic_error while a
+         * partial block is buffered.
+         */
+        LIBCRYPT_FORCE_INLINE constexpr midstate_type export_midstate() const{
+            if(datalen != 0)
+                impl::midstate_error::unaligned("crypt::basic_sha512::export_midstate: not at a block boundary");
+            return midstate_type{state, bitlen};
+        }
+
+        LIBCRYPT_FORCE_INLINE constexpr void import_midstate(const midstate_type& mid){
+            if(mid.bitlen % 1024 != 0)
+                impl::midstate_error::invalid("crypt::basic_sha512::import_midstate: not at a block boundary");
+            datalen = 0;
+            bitlen = mid.bitlen;
+            state = mid.state;
+        }
+
+        // an independent copy, including a buffered partial block
+        constexpr basic_sha512 fork() const{
+            return *this;
+        }
+
+        /**
+         * Compress count whole blocks into mid, without buffering or
+         * padding. The building block for hashing many suffixes after one
+         * shared prefix.
+         */
+        static constexpr void compress(midstate_type& mid, const std::uint8_t* blocks, std::size_t count){
+            transform(mid.state, blocks, count);
+            mid.bitlen += 1024 * static_cast<std::uint64_t>(count);
+        }
+
+        template<typename T>
+        LIBCRYPT_FORCE_INLINE constexpr void update(const T& byte){
+            static_assert((sizeof(T) == 1),
+                          "crypt::basic_sha512::update: T must be byte");
+            impl::probe::update(probe_id, 1);
+            append(static_cast<std::uint8_t>(byte));
+        }
+
+        template<typename Iterator>
+        constexpr void update(Iterator first, Iterator last){
+            static_assert((sizeof(typename std::iterator_traits<Iterator>::value_type) == 1),
+                          "crypt::basic_sha512::update: T::value_type must be byte");
+            if constexpr(impl::is_contiguous_iterator_v<Iterator>){
+                if(!impl::is_constant_evaluated()){
+                    if(first != last)
+                        update_contiguous(reinterpret_cast<const std::uint8_t*>(&*first),
+                                          static_cast<std::size_t>(last - first));
+                    return;
+                }
+            }
+            std::uint64_t sample = impl::probe::call_begin();
+            std::size_t count = 0;
+            for(; first != last; ++first, ++count)
+                append(static_cast<std::uint8_t>(*first));
+            impl::probe::update(probe_id, count, sample);
+        }
+
+        LIBCRYPT_NOINLINE constexpr std::array<std::uint8_t, DigestSize> final(){
+            std::uint64_t sample = impl::probe::call_begin();
+            std::array<std::uint8_t, DigestSize> hash{};
+            std::uint32_t i = datalen;
+
+            // Pad whatever data is left in the buffer.
+            if(datalen < 112){
+                data[i++] = 0x80;
+                while(i < 112)
+                    data[i++] = 0x00;
+            }else{
+                data[i++] = 0x80;
+                while(i < 128)
+                    data[i++] = 0x00;
+                transform(state, data.data());
+                for(std::size_t j = 0; j < 112; j++)
+                    data[j] = 0;
+            }
+
+            // Append the 128-bit message length in bits, the upper half is always zero here.
+            bitlen += datalen * 8;
+            for(i = 0; i < 8; ++i){
+                data[127 - i] = static_cast<std::uint8_t>(bitlen >> (i * 8));
+                data[119 - i] = 0;
+            }
+            transform(state, data.data());
+
+            // SHA uses big endian, copy the state out byte by byte and truncate it to the digest.
+            for(i = 0; i < DigestSize; ++i)
+                hash[i] = static_cast<std::uint8_t>(state[i / 8] >> (56 - (i % 8) * 8));
+
+            impl::probe::final(probe_id, sample);
+            return hash;
+        }
+
+        // digest of [first, last), usable in constant expressions
+        template<typename Iterator>
+        static constexpr std::array<std::uint8_t, DigestSize> hash(Iterator first, Iterator last){
+            basic_sha512 algo;
+            algo.update(first, last);
+            return algo.final();
+        }
+
+        static constexpr std::array<std::uint8_t, DigestSize> hash(std::string_view str){
+            return hash(str.begin(), str.end());
+        }
+    };
+
+    using sha512 = basic_sha512<64>;
+}
+
+#endif /* LIBCRYPT_SHA512_HPP */
@@ -0,0 +1,190 @@
+/**
+ * @file   libcrypt/include/sha_ni.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  Intel SHA extensions kernels for sha1 and sha256
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_SHA_NI_HPP
+#define LIBCRYPT_SHA_NI_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "impl.hpp"
+
+#if defined(LIBCRYPT_X86_KERNELS)
+#include <immintrin.h>
+
+#define LIBCRYPT_SHA_NI_TARGET __attribute__((target("sha,sse4.1"), always_inline))
+
+namespace crypt{
+    namespace impl{
+        namespace sha_ni{
+            // Four rounds of sha256 (group I of 16). The message registers are
+            // used as a ring, w[I % 4] holds the words of the current group.
+            template<std::size_t I>
+            LIBCRYPT_SHA_NI_TARGET inline void sha256_rounds(__m128i& state0, __m128i& state1,
+                                                             __m128i (&w)[4], const std::uint32_t* k,
+                                                             const std::uint8_t* block){
+                const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+                __m128i& cur = w[I % 4];
+
+                if constexpr(I < 4)
+                    cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + I * 16)), mask);
+
+                __m128i msg = _mm_add_epi32(cur, _mm_loadu_si128(reinterpret_cast<const __m128i*>(k + I * 4)));
+                state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+
+                if constexpr(I >= 3 && I < 15){
+                    __m128i& next = w[(I + 1) % 4];
+                    next = _mm_add_epi32(next, _mm_alignr_epi8(cur, w[(I + 3) % 4], 4));
+                    next = _mm_sha256msg2_epu32(next, cur);
+                }
+
+                msg = _mm_shuffle_epi32(msg, 0x0e);
+                state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+                if constexpr(I >= 1 && I < 13)
+                    w[(I + 3) % 4] = _mm_sha256msg1_epu32(w[(I + 3) % 4], cur);
+            }
+
+            template<std::size_t... I>
+            LIBCRYPT_SHA_NI_TARGET inline void sha256_block(__m128i& state0, __m128i& state1,
+                                                            const std::uint32_t* k, const std::uint8_t* block,
+                                                            std::index_sequence<I...>){
+                __m128i w[4];
+                (sha256_rounds<I>(state0, state1, w, k, block), ...);
+            }
+
+            // Four rounds of sha1 (group I of 20), e0/e1 alternate as the
+            // incoming and outgoing e value.
+            template<std::size_t I>
+            LIBCRYPT_SHA_NI_TARGET inline void sha1_rounds(__m128i& abcd, __m128i& e0, __m128i& e1,
+                                                           __m128i (&w)[4], const std::uint8_t* block){
+                const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+                __m128i& cur = w[I % 4];
+                __m128i& ein  = (I % 2 == 0) ? e0 : e1;
+                __m128i& eout = (I % 2 == 0) ? e1 : e0;
+
+                if constexpr(I < 4)
+                    cur = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + I * 16)), mask);
+
+                if constexpr(I == 0)
+                    ein = _mm_add_epi32(ein, cur);
+                else
+                    ein = _mm_sha1nexte_epu32(ein, cur);
+                eout = abcd;
+
+                if constexpr(I >= 3 && I < 19)
+                    w[(I + 1) % 4] = _mm_sha1msg2_epu32(w[(I + 1) % 4], cur);
+
+                abcd = _mm_sha1rnds4_epu32(abcd, ein, I / 5);
+
+                if constexpr(I >= 1 && I < 17)
+                    w[(I + 3) % 4] = _mm_sha1msg1_epu32(w[(I + 3) % 4], cur);
+                if constexpr(I >= 2 && I < 18)
+                    w[(I + 2) % 4] = _mm_xor_si128(w[(I + 2) % 4], cur);
+            }
+
+            template<std::size_t... I>
+            LIBCRYPT_SHA_NI_TARGET inline void sha1_block(__m128i& abcd, __m128i& e0,
+                                                          const std::uint8_t* block,
+                                                          std::index_sequence<I...>){
+                __m128i w[4];
+                __m128i e1;
+                (sha1_rounds<I>(abcd, e0, e1, w, block), ...);
+            }
+        }
+
+        /**
+         * sha256 compression of `blocks` consecutive 64 byte blocks with the
+         * SHA-NI instructions, k is the 64 entry sha256 round constant table.
+         */
+        __attribute__((target("sha,sse4.1"), noinline))
+        inline void sha256_transform_shani(std::uint32_t* state, const std::uint32_t* k,
+                                           const std::uint8_t* block, std::size_t blocks){
+            __m128i tmp    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+            __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+
+            tmp    = _mm_shuffle_epi32(tmp, 0xb1);          // CDAB
+            state1 = _mm_shuffle_epi32(state1, 0x1b);       // EFGH
+            __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);  // ABEF
+            state1 = _mm_blend_epi16(state1, tmp, 0xf0);    // CDGH
+
+            for(; blocks != 0; --blocks, block += 64){
+                const __m128i abef = state0;
+                const __m128i cdgh = state1;
+
+                sha_ni::sha256_block(state0, state1, k, block, std::make_index_sequence<16>{});
+
+                state0 = _mm_add_epi32(state0, abef);
+                state1 = _mm_add_epi32(state1, cdgh);
+            }
+
+            tmp    = _mm_shuffle_epi32(state0, 0x1b);       // FEBA
+            state1 = _mm_shuffle_epi32(state1, 0xb1);       // DCHG
+            state0 = _mm_blend_epi16(tmp, state1, 0xf0);    // DCBA
+            state1 = _mm_alignr_epi8(state1, tmp, 8);       // ABEF
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+        }
+
+        /**
+         * sha1 compression of `blocks` consecutive 64 byte blocks with the
+         * SHA-NI instructions.
+         */
+        __attribute__((target("sha,sse4.1"), noinline))
+        inline void sha1_transform_shani(std::uint32_t* state, const std::uint8_t* block, std::size_t blocks){
+            __m128i abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+            __m128i e0   = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+
+            abcd = _mm_shuffle_epi32(abcd, 0x1b);
+
+            for(; blocks != 0; --blocks, block += 64){
+                const __m128i abcd_save = abcd;
+                const __m128i e0_save   = e0;
+
+                sha_ni::sha1_block(abcd, e0, block, std::make_index_sequence<20>{});
+
+                e0   = _mm_sha1nexte_epu32(e0, e0_save);
+                abcd = _mm_add_epi32(abcd, abcd_save);
+            }
+
+            abcd = _mm_shuffle_epi32(abcd, 0x1b);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abcd);
+            state[4] = static_cast<std::uint32_t>(_mm_extract_epi32(e0, 3));
+        }
+    }
+}
+
+#undef LIBCRYPT_SHA_NI_TARGET
+
+#endif /* LIBCRYPT_X86_KERNELS */
+
+#endif /* LIBCRYPT_SHA_NI_HPP */
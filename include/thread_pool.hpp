@@ -0,0 +1,327 @@
+/**
+ * @file   libcrypt/include/thread_pool.hpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  worker thread pool for the parallel hashing modes
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIBCRYPT_THREAD_POOL_HPP
+#define LIBCRYPT_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace crypt{
+    /**
+     * Work stealing thread pool.
+     *
+     * Every worker owns a task queue. Tasks submitted from a worker go to
+     * its own queue and are run newest first while they are still in its
+     * cache, tasks from outside are dealt out round robin. An idle worker
+     * steals the oldest task of another one before it goes to sleep.
+     */
+    class thread_pool{
+        struct alignas(64) queue{
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<queue>> queues;
+        std::vector<std::thread> workers;
+        std::atomic<std::size_t> queued{0};
+        std::atomic<std::size_t> next_queue{0};
+        std::mutex sleep_mutex;
+        std::condition_variable cv;
+        bool stop = false;
+
+        // the pool and queue of the worker running on this thread
+        struct current_worker{
+            const thread_pool* pool;
+            std::size_t index;
+        };
+
+        static current_worker& current(){
+            static thread_local current_worker self{nullptr, 0};
+            return self;
+        }
+
+        bool pop(std::size_t self, std::function<void()>& task){
+            {
+                queue& own = *queues[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if(!own.tasks.empty()){
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    queued.fetch_sub(1);
+                    return true;
+                }
+            }
+            for(std::size_t i = 1; i < queues.size(); ++i){
+                queue& victim = *queues[(self + i) % queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if(!victim.tasks.empty()){
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    queued.fetch_sub(1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(std::size_t self){
+            current() = current_worker{this, self};
+            for(;;){
+                std::function<void()> task;
+                if(pop(self, task)){
+                    task();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                cv.wait(lock, [this]{ return stop || queued.load() != 0; });
+                if(stop && queued.load() == 0)
+                    return;
+            }
+        }
+
+        /**
+         * The index range of one parallel_for participant, packed into one
+         * word so the owner can take from the front and thieves can split
+         * off the back half with a single compare and swap.
+         */
+        struct alignas(64) range{
+            std::atomic<std::uint64_t> bounds{0};
+
+            static std::uint64_t pack(std::uint64_t begin, std::uint64_t end){
+                return begin << 32 | end;
+            }
+
+            // next index from the front, false once the range is empty
+            bool take(std::size_t& index){
+                std::uint64_t r = bounds.load();
+                for(;;){
+                    const std::uint64_t begin = r >> 32, end = r & 0xffffffff;
+                    if(begin == end)
+                        return false;
+                    if(bounds.compare_exchange_weak(r, pack(begin + 1, end))){
+                        index = static_cast<std::size_t>(begin);
+                        return true;
+                    }
+                }
+            }
+
+            // empty the range, returns how many indices it still held
+            std::size_t clear(){
+                std::uint64_t r = bounds.load();
+                for(;;){
+                    const std::uint64_t begin = r >> 32, end = r & 0xffffffff;
+                    if(begin == end)
+                        return 0;
+                    if(bounds.compare_exchange_weak(r, pack(end, end)))
+                        return static_cast<std::size_t>(end - begin);
+                }
+            }
+
+            // split off the back half into thief, false if nothing is left
+            bool steal(range& thief){
+                std::uint64_t r = bounds.load();
+                for(;;){
+                    const std::uint64_t begin = r >> 32, end = r & 0xffffffff;
+                    if(begin == end)
+                        return false;
+                    const std::uint64_t mid = begin + (end - begin) / 2;
+                    if(bounds.compare_exchange_weak(r, pack(begin, mid))){
+                        thief.bounds.store(pack(mid, end));
+                        return true;
+                    }
+                }
+            }
+        };
+
+        template<typename F>
+        void parallel_range(std::size_t offset, std::size_t count, F& fn){
+            const std::size_t participants = std::min(size() + 1, count);
+
+            struct shared{
+                std::unique_ptr<range[]> ranges;
+                std::atomic<std::size_t> joined{0};
+                std::atomic<bool> failed{false};
+                std::size_t done = 0;
+                std::exception_ptr error;
+                std::mutex mutex;
+                std::condition_variable cv;
+            };
+            auto state = std::make_shared<shared>();
+            state->ranges.reset(new range[participants]);
+            for(std::size_t i = 0; i < participants; ++i)
+                state->ranges[i].bounds.store(range::pack(count * i / participants,
+                                                          count * (i + 1) / participants));
+
+            // every participant drains its own contiguous slice first, then
+            // steals half of the remaining slice of another one. Helpers that
+            // only get to run after everything is done keep the shared state
+            // alive but never touch fn in that case.
+            // The first exception out of fn empties all slices and the indices
+            // that still get taken, from a steal in flight, are skipped. They
+            // all count as done, so the caller wakes up only once no call of
+            // fn is running anymore and rethrows it.
+            auto work = [state, participants, offset, count, &fn]{
+                const std::size_t self = state->joined.fetch_add(1);
+                if(self >= participants)
+                    return;
+                range& own = state->ranges[self];
+                std::size_t finished = 0;
+                for(;;){
+                    std::size_t i;
+                    while(own.take(i)){
+                        ++finished;
+                        if(state->failed.load())
+                            continue;
+                        try{
+                            fn(offset + i);
+                        }catch(...){
+                            {
+                                std::lock_guard<std::mutex> lock(state->mutex);
+                                if(!state->error)
+                                    state->error = std::current_exception();
+                            }
+                            state->failed.store(true);
+                            for(std::size_t r = 0; r < participants; ++r)
+                                finished += state->ranges[r].clear();
+                        }
+                    }
+                    bool stolen = false;
+                    for(std::size_t v = 1; v < participants && !stolen; ++v)
+                        stolen = state->ranges[(self + v) % participants].steal(own);
+                    if(!stolen)
+                        break;
+                }
+                if(finished == 0)
+                    return;
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->done += finished;
+                if(state->done == count)
+                    state->cv.notify_all();
+            };
+
+            for(std::size_t i = 1; i < participants; ++i)
+                submit(work);
+            work();
+
+            std::unique_lock<std::mutex> lock(state->mutex);
+            state->cv.wait(lock, [&]{ return state->done == count; });
+            if(state->error)
+                std::rethrow_exception(state->error);
+        }
+
+    public:
+        explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency()){
+            threads = std::max<std::size_t>(threads, 1);
+            queues.reserve(threads);
+            for(std::size_t i = 0; i < threads; ++i)
+                queues.push_back(std::make_unique<queue>());
+            workers.reserve(threads);
+            for(std::size_t i = 0; i < threads; ++i)
+                workers.emplace_back([this, i]{ run(i); });
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool(){
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                stop = true;
+            }
+            cv.notify_all();
+            for(auto& worker : workers)
+                worker.join();
+        }
+
+        // process wide pool with one worker per hardware thread
+        static thread_pool& global(){
+            static thread_pool pool;
+            return pool;
+        }
+
+        std::size_t size() const{
+            return workers.size();
+        }
+
+        void submit(std::function<void()> task){
+            const current_worker& self = current();
+            const std::size_t index = self.pool == this ? self.index
+                                                        : next_queue.fetch_add(1) % queues.size();
+            {
+                queue& q = *queues[index];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                q.tasks.push_back(std::move(task));
+                queued.fetch_add(1);
+            }
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            cv.notify_one();
+        }
+
+        /**
+         * Call fn(i) for every i in [0, count) and return once all calls
+         * finished. The calling thread works on the range as well.
+         *
+         * Every participant gets a contiguous slice of the indices, so
+         * neighbouring items stay on one core, and steals half of another
+         * slice once its own ran dry.
+         *
+         * If fn throws the remaining indices are skipped and the first
+         * exception is rethrown here once all running calls returned.
+         */
+        template<typename F>
+        void parallel_for(std::size_t count, F&& fn){
+            if(count == 0)
+                return;
+            if(count == 1){
+                fn(std::size_t{0});
+                return;
+            }
+
+            // the packed ranges hold 32 bit indices
+            constexpr std::size_t max = std::numeric_limits<std::uint32_t>::max();
+            for(std::size_t offset = 0; offset < count; offset += max)
+                parallel_range(offset, std::min(max, count - offset), fn);
+        }
+    };
+}
+
+#endif /* LIBCRYPT_THREAD_POOL_HPP */
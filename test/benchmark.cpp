@@ -0,0 +1,390 @@
+/**
+ * @file   libcrypt/test/benchmark.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  throughput and latency benchmark
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "cdc_chunker.hpp"
+#include "djb2.hpp"
+#include "hash_many.hpp"
+#include "hmac.hpp"
+#include "md2.hpp"
+#include "md5.hpp"
+#include "md5_mb.hpp"
+#include "merkle.hpp"
+#include "sdbm.hpp"
+#include "sha1.hpp"
+#include "sha224.hpp"
+#include "sha256.hpp"
+#include "sha256_mb.hpp"
+#include "sha384.hpp"
+#include "sha512.hpp"
+#include "sha512_256.hpp"
+
+#if defined(LIBCRYPT_X86_KERNELS)
+#include <x86intrin.h>
+#endif
+
+/*
+ * usage: benchmark [--max-size=BYTES[K|M|G]] [--min-time=SECONDS]
+ *                  [--samples=N] [--filter=NAME] [--output=FILE]
+ *
+ * Writes one JSON document: throughput (MB/s, cycles/byte) of every
+ * algorithm for message sizes 16 B to --max-size in steps of 4x and per
+ * call latency percentiles for messages up to 1 KiB.
+ */
+
+using clock_type = std::chrono::steady_clock;
+
+struct options{
+    std::size_t max_size = std::size_t{1} << 30;
+    double min_time = 0.25;
+    std::size_t samples = 20000;
+    std::string_view filter; // point into argv
+    std::string_view output;
+};
+
+static volatile std::uint32_t sink;
+
+template<typename T>
+static void consume(const T& digest){
+    if constexpr(std::is_integral_v<T>)
+        sink = sink + static_cast<std::uint32_t>(digest);
+    else
+        sink = sink + digest[0];
+}
+
+static std::uint64_t ticks(){
+#if defined(LIBCRYPT_X86_KERNELS)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(clock_type::now().time_since_epoch().count());
+#endif
+}
+
+// ticks per second of ticks(), measured against the steady clock
+static double tick_rate(){
+    auto t0 = clock_type::now();
+    std::uint64_t c0 = ticks();
+    while(clock_type::now() - t0 < std::chrono::milliseconds(200));
+    std::uint64_t c1 = ticks();
+    std::chrono::duration<double> elapsed = clock_type::now() - t0;
+    return static_cast<double>(c1 - c0) / elapsed.count();
+}
+
+/*
+ * One benchmarked algorithm: run() hashes data[0, size) and reports how
+ * many bytes it actually consumed (multi-buffer kernels hash one message
+ * of that size per lane).
+ */
+struct algorithm{
+    const char* name;
+    std::size_t (*run)(const std::uint8_t* data, std::size_t size);
+};
+
+template<typename Algo>
+static std::size_t run_stream(const std::uint8_t* data, std::size_t size){
+    Algo algo;
+    algo.update(data, data + size);
+    consume(algo.final());
+    return size;
+}
+
+template<typename MB>
+static std::size_t run_multibuffer(const std::uint8_t* data, std::size_t size){
+    const std::uint8_t* messages[MB::lanes];
+    std::size_t lengths[MB::lanes];
+    typename MB::digest_type digests[MB::lanes];
+    for(std::size_t i = 0; i < MB::lanes; i++){
+        messages[i] = data;
+        lengths[i] = size;
+    }
+    MB::hash(messages, lengths, MB::lanes, digests);
+    consume(digests[MB::lanes - 1]);
+    return size * MB::lanes;
+}
+
+// a batch of 64 copies of the message through hash_many()
+template<typename Hash>
+static std::size_t run_many(const std::uint8_t* data, std::size_t size){
+    constexpr std::size_t count = 64;
+    const std::uint8_t* messages[count];
+    std::size_t lengths[count];
+    decltype(std::declval<Hash&>().final()) digests[count];
+    for(std::size_t i = 0; i < count; i++){
+        messages[i] = data;
+        lengths[i] = size;
+    }
+    crypt::hash_many<Hash>(messages, lengths, count, digests);
+    consume(digests[count - 1]);
+    return size * count;
+}
+
+template<typename Hash>
+static std::size_t run_cdc(const std::uint8_t* data, std::size_t size){
+    crypt::cdc_chunker<Hash> chunker;
+    auto emit = [](const typename crypt::cdc_chunker<Hash>::chunk& c){ consume(c.digest); };
+    chunker.update(data, data + size, emit);
+    chunker.final(emit);
+    return size;
+}
+
+// the message as a column of 16 byte keys through hash_column(), 4096 rows at a time
+template<typename Hash>
+static std::size_t run_column(const std::uint8_t* data, std::size_t size){
+    constexpr std::size_t key = 16;
+    constexpr std::size_t rows = 4096;
+    static const std::vector<std::int32_t> offsets = []{
+        std::vector<std::int32_t> o(rows + 1);
+        for(std::size_t i = 0; i <= rows; i++)
+            o[i] = static_cast<std::int32_t>(i * key);
+        return o;
+    }();
+    static std::uint32_t hashes[rows];
+    std::size_t done = 0;
+    while(size - done >= key){
+        const std::size_t n = std::min(rows, (size - done) / key);
+        Hash::hash_column(data + done, offsets.data(), n, hashes);
+        done += n * key;
+    }
+    consume(hashes[0]);
+    return done;
+}
+
+// keyed once, every message resumes from the cached pad midstates
+template<typename Hash>
+static std::size_t run_hmac(const std::uint8_t* data, std::size_t size){
+    static crypt::hmac<Hash> algo{std::string_view{"benchmark key"}};
+    algo.reset();
+    algo.update(data, data + size);
+    consume(algo.final());
+    return size;
+}
+
+template<typename Hash>
+static std::size_t run_merkle(const std::uint8_t* data, std::size_t size){
+    consume(crypt::merkle<Hash>::hash(data, data + size));
+    return size;
+}
+
+static const algorithm algorithms[] = {
+    {"md2",               run_stream<crypt::md2>},
+    {"md5",               run_stream<crypt::md5>},
+    {"sha1",              run_stream<crypt::sha1>},
+    {"sha224",            run_stream<crypt::sha224>},
+    {"sha256",            run_stream<crypt::sha256>},
+    {"md5<compact>",      run_stream<crypt::basic_md5<crypt::policy::compact>>},
+    {"sha1<compact>",     run_stream<crypt::basic_sha1<crypt::policy::compact>>},
+    {"sha224<compact>",   run_stream<crypt::basic_sha224<crypt::policy::compact>>},
+    {"sha256<compact>",   run_stream<crypt::basic_sha256<crypt::policy::compact>>},
+    {"sha384",            run_stream<crypt::sha384>},
+    {"sha512",            run_stream<crypt::sha512>},
+    {"sha512_256",        run_stream<crypt::sha512_256>},
+    {"djb2",              run_stream<crypt::djb2>},
+    {"sdbm",              run_stream<crypt::sdbm>},
+    {"md5_x4",            run_multibuffer<crypt::md5_x4>},
+    {"md5_x8",            run_multibuffer<crypt::md5_x8>},
+    {"md5_x16",           run_multibuffer<crypt::md5_x16>},
+    {"sha256_x8",         run_multibuffer<crypt::sha256_x8>},
+    {"sha256_x16",        run_multibuffer<crypt::sha256_x16>},
+    {"hash_many<md5>",    run_many<crypt::md5>},
+    {"hash_many<sha256>", run_many<crypt::sha256>},
+    {"cdc<sha256>",       run_cdc<crypt::sha256>},
+    {"column<djb2>",      run_column<crypt::djb2>},
+    {"column<sdbm>",      run_column<crypt::sdbm>},
+    {"hmac<sha256>",      run_hmac<crypt::sha256>},
+    {"merkle<sha256>",    run_merkle<crypt::sha256>},
+};
+
+static std::size_t parse_size(const char* s){
+    char* end;
+    std::size_t n = std::strtoull(s, &end, 10);
+    switch(*end){
+    case 'k': case 'K': return n << 10;
+    case 'm': case 'M': return n << 20;
+    case 'g': case 'G': return n << 30;
+    default:            return n;
+    }
+}
+
+static bool parse(int argc, char** argv, options& opt){
+    for(int i = 1; i < argc; i++){
+        const char* arg = argv[i];
+        auto value = [arg](const char* key) -> const char*{
+            std::size_t len = std::strlen(key);
+            return std::strncmp(arg, key, len) == 0 ? arg + len : nullptr;
+        };
+
+        const char* v;
+        if((v = value("--max-size=")))
+            opt.max_size = parse_size(v);
+        else if((v = value("--min-time=")))
+            opt.min_time = std::strtod(v, nullptr);
+        else if((v = value("--samples=")))
+            opt.samples = parse_size(v);
+        else if((v = value("--filter=")))
+            opt.filter = v;
+        else if((v = value("--output=")))
+            opt.output = v;
+        else{
+            std::cerr << "usage: " << argv[0]
+                      << " [--max-size=BYTES[K|M|G]] [--min-time=SECONDS]"
+                      << " [--samples=N] [--filter=NAME] [--output=FILE]\n";
+            return false;
+        }
+    }
+    return opt.max_size >= 16 && opt.samples > 0;
+}
+
+static void throughput(std::ostream& out, const algorithm& algo, const std::vector<std::uint8_t>& data,
+                       const options& opt, double rate, bool& first){
+    for(std::size_t size = 16;; size *= 4){
+        algo.run(data.data(), size); // warm up caches and dispatch
+
+        std::size_t iterations = 0;
+        std::size_t bytes = 0;
+        std::uint64_t cycles = 0;
+        auto t0 = clock_type::now();
+        std::chrono::duration<double> elapsed{0};
+        do{
+            // batches keep the clock out of the loop for small messages
+            std::size_t batch = std::max<std::size_t>(1, (std::size_t{1} << 16) / size);
+            std::uint64_t c0 = ticks();
+            for(std::size_t i = 0; i < batch; i++)
+                bytes += algo.run(data.data(), size);
+            cycles += ticks() - c0;
+            iterations += batch;
+            elapsed = clock_type::now() - t0;
+        }while(elapsed.count() < opt.min_time);
+
+        double seconds = static_cast<double>(cycles) / rate;
+        out << (first ? "\n" : ",\n")
+            << "    {\"algorithm\": \"" << algo.name << "\", \"size\": " << size
+            << ", \"iterations\": " << iterations << ", \"bytes\": " << bytes
+            << ", \"seconds\": " << seconds
+            << ", \"mb_per_s\": " << static_cast<double>(bytes) / seconds / 1e6
+            << ", \"cycles_per_byte\": " << static_cast<double>(cycles) / static_cast<double>(bytes) << "}";
+        first = false;
+
+        if(size > opt.max_size / 4)
+            break;
+    }
+}
+
+static double percentile(const std::vector<std::uint64_t>& sorted, double p){
+    std::size_t i = static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return static_cast<double>(sorted[i]);
+}
+
+static void latency(std::ostream& out, const algorithm& algo, const std::vector<std::uint8_t>& data,
+                    const options& opt, double rate, bool& first){
+    std::vector<std::uint64_t> samples(opt.samples);
+    const double ns = 1e9 / rate;
+
+    for(std::size_t size = 16; size <= std::min<std::size_t>(1024, opt.max_size); size *= 4){
+        algo.run(data.data(), size);
+        for(auto& i : samples){
+            std::uint64_t c0 = ticks();
+            algo.run(data.data(), size);
+            i = ticks() - c0;
+        }
+        std::sort(samples.begin(), samples.end());
+
+        out << (first ? "\n" : ",\n")
+            << "    {\"algorithm\": \"" << algo.name << "\", \"size\": " << size
+            << ", \"samples\": " << samples.size()
+            << ", \"p50_ns\": "  << percentile(samples, 0.50)  * ns
+            << ", \"p90_ns\": "  << percentile(samples, 0.90)  * ns
+            << ", \"p99_ns\": "  << percentile(samples, 0.99)  * ns
+            << ", \"p999_ns\": " << percentile(samples, 0.999) * ns
+            << ", \"max_ns\": "  << static_cast<double>(samples.back()) * ns << "}";
+        first = false;
+    }
+}
+
+int main(int argc, char** argv){
+    options opt;
+    if(!parse(argc, argv, opt))
+        return 1;
+
+    std::ofstream file;
+    if(!opt.output.empty()){
+        file.open(std::string{opt.output});
+        if(!file){
+            std::cerr << "cannot open " << opt.output << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = opt.output.empty() ? std::cout : file;
+
+    std::vector<std::uint8_t> data(opt.max_size);
+    std::uint32_t x = 0x2545f491;
+    for(auto& b : data){
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        b = static_cast<std::uint8_t>(x);
+    }
+
+    const double rate = tick_rate();
+    const auto& cpu = crypt::impl::cpu::features();
+
+    out << std::boolalpha << "{\n"
+        << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+        << "  \"tick_hz\": " << rate << ",\n"
+        << "  \"cpu\": {\"sse2\": " << cpu.sse2 << ", \"ssse3\": " << cpu.ssse3
+        << ", \"sse41\": " << cpu.sse41 << ", \"avx2\": " << cpu.avx2
+        << ", \"bmi2\": " << cpu.bmi2 << ", \"sha\": " << cpu.sha
+        << ", \"avx512f\": " << cpu.avx512f << ", \"avx512bw\": " << cpu.avx512bw << "},\n";
+
+    bool first = true;
+    out << "  \"throughput\": [";
+    for(const auto& algo : algorithms)
+        if(opt.filter.empty() || opt.filter == algo.name)
+            throughput(out, algo, data, opt, rate, first);
+    out << "\n  ],\n";
+
+    first = true;
+    out << "  \"latency\": [";
+    for(const auto& algo : algorithms)
+        if(opt.filter.empty() || opt.filter == algo.name)
+            latency(out, algo, data, opt, rate, first);
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,165 @@
+/**
+ * @file   libcrypt/test/cdc_chunker_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  cdc_chunker tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include <cdc_chunker.hpp>
+#include <sha1.hpp>
+#include <sha256.hpp>
+
+using chunker = crypt::cdc_chunker<crypt::sha256>;
+
+static bool same(const std::vector<chunker::chunk>& a, const std::vector<chunker::chunk>& b){
+    if(a.size() != b.size())
+        return false;
+    for(std::size_t i = 0; i < a.size(); ++i)
+        if(a[i].offset != b[i].offset || a[i].size != b[i].size || a[i].digest != b[i].digest)
+            return false;
+    return true;
+}
+
+int main(){
+    // xorshift noise, content defined boundaries need some entropy
+    std::vector<std::uint8_t> txt(4 << 20);
+    std::uint32_t x = 2463534242;
+    for(auto& i : txt){
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        i = static_cast<std::uint8_t>(x);
+    }
+
+    const auto chunks = chunker::split(txt.begin(), txt.end());
+    {
+        // contiguous, within the size limits and every digest is the one of its bytes
+        std::uint64_t offset = 0;
+        for(std::size_t i = 0; i < chunks.size(); ++i){
+            const auto& c = chunks[i];
+            crypt::sha256 algo;
+            algo.update(txt.begin() + static_cast<std::ptrdiff_t>(c.offset),
+                        txt.begin() + static_cast<std::ptrdiff_t>(c.offset + c.size));
+            if(c.offset != offset || c.size > chunker::default_max_size ||
+               (c.size < chunker::default_min_size && i + 1 != chunks.size()) ||
+               algo.final() != c.digest){
+                std::cerr << "failed\n";
+                return 1;
+            }
+            offset += c.size;
+        }
+        const std::size_t avg = txt.size() / chunks.size();
+        std::cout << chunks.size() << " chunks, " << avg << " bytes on average\n";
+        if(offset != txt.size() || avg < chunker::default_avg_size / 2 || avg > chunker::default_avg_size * 2){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // the boundaries do not depend on how the stream is split
+        chunker streaming;
+        std::vector<chunker::chunk> streamed;
+        auto emit = [&](const chunker::chunk& c){ streamed.push_back(c); };
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = (n * 7 + 3) % 100003)
+            streaming.update(txt.begin() + static_cast<std::ptrdiff_t>(i),
+                             txt.begin() + static_cast<std::ptrdiff_t>(std::min(txt.size(), i + n)), emit);
+        streaming.final(emit);
+        if(!same(chunks, streamed) ||
+           streaming.statistics().bytes != txt.size() || streaming.statistics().chunks != chunks.size()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // an insertion near the start only changes the chunks around it
+        std::vector<std::uint8_t> edited(txt);
+        edited.insert(edited.begin() + 1000, {1, 2, 3});
+        const auto shifted = chunker::split(edited.begin(), edited.end());
+
+        std::set<chunker::digest_type> known;
+        for(const auto& c : chunks)
+            known.insert(c.digest);
+        std::size_t shared = 0;
+        for(const auto& c : shifted)
+            shared += known.count(c.digest);
+        if(shared + 3 < chunks.size()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // non contiguous input, other hashers and sizes, forced cuts on constant data
+        std::vector<std::uint8_t> small(txt.begin(), txt.begin() + 50000);
+        std::list<std::uint8_t> lst(small.begin(), small.end());
+        const auto a = crypt::cdc_chunker<crypt::sha1>::split(small.begin(), small.end(), 256, 1024, 4096);
+        const auto b = crypt::cdc_chunker<crypt::sha1>::split(lst.begin(), lst.end(), 256, 1024, 4096);
+        if(a.size() != b.size() || a.empty() || a.back().digest != b.back().digest){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        std::vector<std::uint8_t> zeros(10000);
+        const auto c = chunker::split(zeros.begin(), zeros.end(), 64, 256, 1000);
+        if(c.size() != 10 || c[3].size != 1000 || !chunker::split(zeros.end(), zeros.end()).empty()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        bool thrown = false;
+        try{
+            chunker invalid{4096, 1024, 8192};
+        }catch(const std::invalid_argument&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    if(sizeof(std::size_t) == 8){
+        // the strict mask would need more than 64 bits
+        bool thrown = false;
+        try{
+            const std::size_t huge = std::size_t{1} << (sizeof(std::size_t) * 8 - 2);
+            chunker invalid{1, huge, huge};
+        }catch(const std::invalid_argument&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
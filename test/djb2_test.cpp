@@ -0,0 +1,251 @@
+/**
+ * @file   libcrypt/test/djb2_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  djb2 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <djb2.hpp>
+
+static bool check(const std::string& txt, std::uint32_t output){
+    crypt::djb2 algo;
+    algo.update(txt.begin(), txt.end());
+    auto res = algo.final();
+    std::cout << std::hex << res << "\n" << output << "\n";
+    return res == output;
+}
+
+int main(){
+    if(!check("", 0x00001505) ||
+       !check("abc", 0x0b885c8b) ||
+       !check("hello world", 0x3551c8c1) ||
+       !check("The quick brown fox jumps over the lazy dog", 0x34cc38de)){
+        std::cerr << "failed\n";
+        return 1;
+    }
+    {
+        // bytes above 0x7f are sign extended where char is signed
+        if(std::is_signed_v<char> && !check("gr\xc3\xbc" "ezi", 0x01e6c405)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        constexpr auto res = crypt::djb2::hash("hello world");
+        static_assert(res == 0x3551c8c1, "crypt::djb2::hash is not constexpr");
+
+        std::vector<std::uint8_t> txt{'a', 'b', 'c'};
+        if(crypt::djb2::hash(txt.begin(), txt.end()) != 0x0b885c8b){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // the default seed is the classic start value
+        static_assert(crypt::djb2::hash("abc", 5381) == crypt::djb2::hash("abc"), "");
+
+        crypt::djb2 algo{0x9e3779b9};
+        algo.update('a');
+        algo.reset();
+        algo.update('a');
+        if(algo.final() != crypt::djb2::hash("a", 0x9e3779b9) || algo.final() == crypt::djb2::hash("a")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // the vector kernels against the byte loop, for every tail length,
+        // unaligned starts and bytes above 0x7f as char and as std::uint8_t
+        std::vector<char> txt(400);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<char>(i * 151 + 17);
+        std::vector<std::uint8_t> bytes(txt.begin(), txt.end());
+
+        for(bool scalar : {false, true}){
+            crypt::force_scalar(scalar);
+            for(std::size_t offset = 0; offset < 4; ++offset){
+                for(std::size_t n = 0; offset + n <= 300; ++n){
+                    crypt::djb2 bulk_char, bulk_byte, ref_char, ref_byte;
+                    bulk_char.update(txt.begin() + offset, txt.begin() + offset + n);
+                    bulk_byte.update(bytes.begin() + offset, bytes.begin() + offset + n);
+                    for(std::size_t i = offset; i < offset + n; ++i){
+                        ref_char.update(txt[i]);
+                        ref_byte.update(bytes[i]);
+                    }
+                    if(bulk_char.final() != ref_char.final() || bulk_byte.final() != ref_byte.final()){
+                        std::cerr << "failed\n";
+                        return 1;
+                    }
+                }
+            }
+        }
+        crypt::force_scalar(false);
+    }
+    {
+        // hash(a || b) from hash(a), hash(b) and b's length, at every split
+        constexpr std::string_view txt = "The quick brown fox jumps over the lazy dog";
+        static_assert(crypt::djb2::combine(crypt::djb2::hash(txt.substr(0, 9)), crypt::djb2::hash(txt.substr(9)),
+                                           txt.size() - 9) == crypt::djb2::hash(txt), "");
+
+        for(std::uint32_t seed : {0u, 5381u, 0x9e3779b9u}){
+            for(std::size_t split = 0; split <= txt.size(); ++split){
+                const std::string_view a = txt.substr(0, split), b = txt.substr(split);
+                if(crypt::djb2::combine(crypt::djb2::hash(a, seed), crypt::djb2::hash(b, seed), b.size(), seed) !=
+                   crypt::djb2::hash(txt, seed)){
+                    std::cerr << "failed\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    {
+        // the parallel update against the serial one, with a partial last chunk
+        std::vector<std::uint8_t> txt(3 * 1024 * 1024 + 12345);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 151 + (i >> 13));
+
+        crypt::thread_pool pool{4};
+        crypt::djb2 serial{0x9e3779b9}, parallel{0x9e3779b9};
+        serial.update(txt.begin(), txt.end());
+        parallel.update(txt.begin(), txt.end(), pool);
+        parallel.update(txt.begin(), txt.begin() + 100, pool);
+        serial.update(txt.begin(), txt.begin() + 100);
+        if(parallel.final() != serial.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        // empty ranges, including ones that have no element to point at
+        std::vector<std::uint8_t> none;
+        std::string nothing;
+        parallel.update(none.begin(), none.end(), pool);
+        parallel.update(nothing.begin(), nothing.end(), pool);
+        parallel.update(txt.begin(), txt.begin(), pool);
+        if(parallel.final() != serial.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // column hashes against hash() per row: empty, short and long rows,
+        // a column starting at a nonzero offset, char and std::uint8_t bytes,
+        // 32 and 64 bit offsets and row counts that leave partial groups
+        std::vector<char> chars(20000);
+        for(std::size_t i = 0; i < chars.size(); i++)
+            chars[i] = static_cast<char>(i * 151 + (i >> 7));
+        std::vector<std::uint8_t> bytes(chars.begin(), chars.end());
+
+        for(std::int32_t first : {0, 1, 3, 100}){
+            std::vector<std::int32_t> offsets32{first};
+            for(std::size_t i = 0; offsets32.back() < 19800; i++)
+                offsets32.push_back(offsets32.back() + static_cast<std::int32_t>((i * 37 + 11) % (i % 7 == 0 ? 150 : 23)));
+            std::vector<std::int64_t> offsets64(offsets32.begin(), offsets32.end());
+
+            for(bool scalar : {false, true}){
+                crypt::force_scalar(scalar);
+                for(std::size_t rows : {std::size_t{0}, std::size_t{1}, std::size_t{7}, std::size_t{17}, offsets32.size() - 1}){
+                    std::vector<std::uint32_t> h_char(rows), h_byte(rows), h_wide(rows);
+                    crypt::djb2::hash_column(chars.data(), offsets32.data(), rows, h_char.data(), 0x9e3779b9);
+                    crypt::djb2::hash_column(bytes.data(), offsets32.data(), rows, h_byte.data(), 0x9e3779b9);
+                    crypt::djb2::hash_column(bytes.data(), offsets64.data(), rows, h_wide.data(), 0x9e3779b9);
+                    for(std::size_t i = 0; i < rows; ++i){
+                        crypt::djb2 ref_char{0x9e3779b9}, ref_byte{0x9e3779b9};
+                        ref_char.update(chars.begin() + offsets32[i], chars.begin() + offsets32[i + 1]);
+                        ref_byte.update(bytes.begin() + offsets32[i], bytes.begin() + offsets32[i + 1]);
+                        if(h_char[i] != ref_char.final() || h_byte[i] != ref_byte.final() || h_wide[i] != ref_byte.final()){
+                            std::cerr << "failed\n";
+                            return 1;
+                        }
+                    }
+                }
+            }
+            crypt::force_scalar(false);
+        }
+    }
+    {
+        // the 64 bit variant, its low half is the 32 bit hash
+        static_assert(crypt::djb2_64::hash("hello world") == 0xc0943fd43551c8c1, "");
+        static_assert(crypt::djb2_64::hash("The quick brown fox jumps over the lazy dog") == 0x36d23eef34cc38de, "");
+        static_assert(std::is_same_v<crypt::djb2, crypt::basic_djb2<std::uint32_t>>, "");
+
+        std::vector<char> txt(3000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<char>(i * 151 + 17);
+        const std::string_view str{txt.data(), txt.size()};
+
+        crypt::djb2_64 bulk{0x9e3779b97f4a7c15}, ref{0x9e3779b97f4a7c15};
+        bulk.update(txt.begin(), txt.end());
+        for(char c : txt)
+            ref.update(c);
+        if(bulk.final() != ref.final() ||
+           crypt::djb2_64::combine(crypt::djb2_64::hash(str.substr(0, 1234)), crypt::djb2_64::hash(str.substr(1234)),
+                                   str.size() - 1234) != crypt::djb2_64::hash(str)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        const std::int64_t offsets[] = {0, 3, 3, 40, 2000, 2017};
+        std::uint64_t hashes[5];
+        crypt::djb2_64::hash_column(txt.data(), offsets, 5, hashes);
+        for(std::size_t i = 0; i < 5; ++i){
+            const auto length = static_cast<std::size_t>(offsets[i + 1] - offsets[i]);
+            if(hashes[i] != crypt::djb2_64::hash(str.substr(static_cast<std::size_t>(offsets[i]), length))){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+    {
+        // the transparent hasher takes every string type without a copy
+        static_assert(std::is_void_v<crypt::djb2::hasher::is_transparent>, "");
+        const std::string key = "hello world";
+        const crypt::djb2::hasher h;
+        const crypt::djb2_64::hasher seeded{12345};
+        if(h(key) != h(std::string_view{key}) || h(key) != h("hello world") ||
+           h(key) != static_cast<std::size_t>(crypt::djb2::hash(key)) ||
+           seeded(key) != static_cast<std::size_t>(crypt::djb2_64::hash(key, 12345))){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        std::unordered_map<std::string, int, crypt::djb2::hasher, std::equal_to<>> map;
+        map["hello"] = 1;
+        map["world"] = 2;
+        if(map.at("hello") != 1 || map.count("world") != 1 || map.count("abc") != 0){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * @file   libcrypt/test/hash_file_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  file hashing tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "djb2.hpp"
+#include "hash_file.hpp" /* pulls in the posix headers */
+#include "md2.hpp"
+#include "md5.hpp"
+#include "sdbm.hpp"
+#include "sha1.hpp"
+#include "sha224.hpp"
+#include "sha256.hpp"
+
+template<typename Algo>
+auto hash_memory(const std::vector<std::uint8_t>& data){
+    Algo algo;
+    algo.update(data.begin(), data.end());
+    return algo.final();
+}
+
+static std::vector<std::uint8_t> make_data(std::size_t len){
+    std::vector<std::uint8_t> data(len);
+    std::uint32_t x = 0x12345678;
+    for(auto& b : data){
+        x = x * 1664525u + 1013904223u;
+        b = static_cast<std::uint8_t>(x >> 24);
+    }
+    return data;
+}
+
+static std::string write_file(const std::vector<std::uint8_t>& data){
+    char name[] = "/tmp/libcrypt_hash_file_XXXXXX";
+    int fd = ::mkstemp(name);
+    if(fd < 0)
+        return {};
+    std::size_t done = 0;
+    while(done < data.size()){
+        ::ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if(n <= 0)
+            break;
+        done += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+    return name;
+}
+
+template<typename Algo>
+bool check(const std::string& path, const std::vector<std::uint8_t>& data){
+    return crypt::hash_file<Algo>(path) == hash_memory<Algo>(data);
+}
+
+int main(){
+    for(std::size_t len : {std::size_t{0}, std::size_t{1}, std::size_t{63}, std::size_t{64},
+                           std::size_t{4097}, std::size_t{3 << 20}}){
+        auto data = make_data(len);
+        std::string path = write_file(data);
+        if(path.empty()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        bool ok = check<crypt::md2>(path, data) &&
+            check<crypt::md5>(path, data) &&
+            check<crypt::sha1>(path, data) &&
+            check<crypt::sha224>(path, data) &&
+            check<crypt::sha256>(path, data) &&
+            check<crypt::djb2>(path, data) &&
+            check<crypt::sdbm>(path, data);
+        std::remove(path.c_str());
+
+        if(!ok){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+
+    {
+        // hashing starts at the current offset of the descriptor
+        auto data = make_data(10000);
+        std::string path = write_file(data);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        ::lseek(fd, 5000, SEEK_SET);
+        auto digest = crypt::hash_file<crypt::sha256>(fd);
+        ::close(fd);
+        std::remove(path.c_str());
+
+        std::vector<std::uint8_t> tail(data.begin() + 5000, data.end());
+        if(digest != hash_memory<crypt::sha256>(tail)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+
+    {
+        // pipes can not be mapped and go through read()
+        auto data = make_data((1 << 20) + 12345);
+        int fds[2];
+        if(::pipe(fds) != 0){
+            std::cerr << "failed\n";
+            return 1;
+        }
+        std::thread writer{[&]{
+            std::size_t done = 0;
+            while(done < data.size()){
+                ::ssize_t n = ::write(fds[1], data.data() + done, data.size() - done);
+                if(n <= 0)
+                    break;
+                done += static_cast<std::size_t>(n);
+            }
+            ::close(fds[1]);
+        }};
+        auto digest = crypt::hash_file<crypt::sha256>(fds[0]);
+        writer.join();
+        ::close(fds[0]);
+
+        if(digest != hash_memory<crypt::sha256>(data)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+
+    {
+        // procfs files are regular files that report a size of 0
+        int fd = ::open("/proc/version", O_RDONLY);
+        if(fd >= 0){
+            std::vector<std::uint8_t> data;
+            std::uint8_t buf[256];
+            ::ssize_t n;
+            while((n = ::read(fd, buf, sizeof(buf))) > 0)
+                data.insert(data.end(), buf, buf + n);
+            ::lseek(fd, 0, SEEK_SET);
+            auto digest = crypt::hash_file<crypt::sha256>(fd);
+            ::close(fd);
+
+            if(data.empty() || digest != hash_memory<crypt::sha256>(data)){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+
+    {
+        bool thrown = false;
+        try{
+            crypt::hash_file<crypt::sha256>(std::string{"/nonexistent/libcrypt"});
+        }catch(const std::system_error&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/**
+ * @file   libcrypt/test/hash_many_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  hash_many tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <djb2.hpp>
+#include <hash_many.hpp>
+#include <md2.hpp>
+#include <md5.hpp>
+#include <sdbm.hpp>
+#include <sha1.hpp>
+#include <sha224.hpp>
+#include <sha256.hpp>
+#include <sha512.hpp>
+
+// hash_many() against hashing every message on its own
+template<typename Hash>
+static bool check(const std::vector<std::vector<std::uint8_t>>& messages, crypt::thread_pool& pool){
+    const auto digests = crypt::hash_many<Hash>(messages, pool);
+    if(digests.size() != messages.size())
+        return false;
+    for(std::size_t i = 0; i < messages.size(); ++i){
+        Hash algo;
+        algo.update(messages[i].begin(), messages[i].end());
+        if(algo.final() != digests[i])
+            return false;
+    }
+    return true;
+}
+
+int main(){
+    // mostly short messages of every length around the padding boundaries,
+    // with a few long ones in between that break the groups
+    std::vector<std::vector<std::uint8_t>> messages;
+    for(std::size_t i = 0; i < 3000; ++i){
+        const std::size_t len = i % 500 == 7 ? 100000 + i : i % 200;
+        std::vector<std::uint8_t> msg(len);
+        for(std::size_t j = 0; j < len; ++j)
+            msg[j] = static_cast<std::uint8_t>(i * 7 + j * 31);
+        messages.push_back(std::move(msg));
+    }
+
+    crypt::thread_pool single{1};
+    crypt::thread_pool pool{4};
+    for(bool scalar : {false, true}){
+        crypt::force_scalar(scalar);
+        for(crypt::thread_pool* workers : {&single, &pool}){
+            if(!check<crypt::md5>(messages, *workers) ||
+               !check<crypt::sha1>(messages, *workers) ||
+               !check<crypt::sha224>(messages, *workers) ||
+               !check<crypt::sha256>(messages, *workers) ||
+               !check<crypt::sha512>(messages, *workers) ||
+               !check<crypt::djb2>(messages, *workers) ||
+               !check<crypt::sdbm>(messages, *workers)){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+    crypt::force_scalar(false);
+
+    {
+        // md2 is slow, a few messages are enough
+        std::vector<std::vector<std::uint8_t>> few(messages.begin(), messages.begin() + 50);
+        if(!check<crypt::md2>(few, pool)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // strings, nothing and the pointer interface
+        std::vector<std::string> strings{"", "a", "abc"};
+        if(crypt::hash_many<crypt::sha256>(strings)[2] != crypt::sha256::hash("abc") ||
+           !crypt::hash_many<crypt::sha256>(std::vector<std::string>{}).empty()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        const std::uint8_t* pointers[2] = {messages[5].data(), messages[199].data()};
+        const std::size_t lengths[2] = {messages[5].size(), messages[199].size()};
+        crypt::sha1::digest_type digests[2];
+        crypt::hash_many<crypt::sha1>(pointers, lengths, 2, digests, pool);
+        crypt::sha1 algo;
+        algo.update(messages[199].begin(), messages[199].end());
+        if(digests[1] != algo.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // an exception out of any participant ends up with the caller and
+        // the pool stays usable
+        for(std::size_t every : {std::size_t{1}, std::size_t{997}}){
+            bool thrown = false;
+            std::atomic<std::size_t> calls{0};
+            try{
+                pool.parallel_for(100000, [&](std::size_t i){
+                    calls.fetch_add(1);
+                    if(i % every == every - 1)
+                        throw std::runtime_error{"parallel_for"};
+                });
+            }catch(const std::runtime_error&){
+                thrown = true;
+            }
+            if(!thrown || calls.load() == 100000){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+
+        std::atomic<std::size_t> sum{0};
+        pool.parallel_for(1000, [&](std::size_t i){ sum.fetch_add(i); });
+        if(sum.load() != 1000 * 999 / 2){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file   libcrypt/test/hash_pipeline_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  hash_pipeline tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <hash_pipeline.hpp>
+#include <md5.hpp>
+#include <sha256.hpp>
+
+int main(){
+    std::vector<std::uint8_t> txt(1 << 20);
+    for(std::size_t i = 0; i < txt.size(); i++)
+        txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+    crypt::sha256 ref;
+    ref.update(txt.begin(), txt.end());
+    const auto expected = ref.final();
+
+    {
+        // uneven copies through a small ring, so the producer has to wait
+        crypt::hash_pipeline<crypt::sha256> pipe{2, 4096};
+        auto digest = pipe.get_future();
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 % 9973 + 1)
+            pipe.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        pipe.finish();
+        if(digest.get() != expected){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // filled in place, the way a read() loop would use it
+        crypt::hash_pipeline<crypt::sha256> pipe{3, 10000};
+        auto digest = pipe.get_future();
+        if(pipe.buffer_size() % crypt::hash_pipeline<crypt::sha256>::buffer_align != 0 || pipe.capacity() != 3){
+            std::cerr << "failed\n";
+            return 1;
+        }
+        for(std::size_t i = 0; i < txt.size();){
+            std::uint8_t* buffer = pipe.acquire();
+            const std::size_t n = std::min(pipe.buffer_size() - 17, txt.size() - i);
+            std::copy(txt.begin() + i, txt.begin() + i + n, buffer);
+            pipe.commit(n);
+            i += n;
+        }
+        pipe.finish();
+        if(digest.get() != expected){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // views of the caller's memory mixed with copies and single bytes
+        crypt::hash_pipeline<crypt::sha256> pipe{4, 4096};
+        auto digest = pipe.get_future();
+        pipe.submit(txt.data(), 100000);
+        pipe.update(txt.begin() + 100000, txt.begin() + 100003);
+        pipe.update(txt[100003]);
+        pipe.submit(txt.data() + 100004, txt.size() - 100004);
+        pipe.finish();
+        if(digest.get() != expected){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // back pressure: try_acquire() fails only while the ring is full
+        crypt::hash_pipeline<crypt::sha256> pipe{2, 4096};
+        auto digest = pipe.get_future();
+        std::size_t done = 0;
+        while(done < txt.size()){
+            std::uint8_t* buffer = pipe.try_acquire();
+            if(buffer == nullptr){
+                if(pipe.pending() != pipe.capacity()){
+                    std::cerr << "failed\n";
+                    return 1;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+            const std::size_t n = std::min(pipe.buffer_size(), txt.size() - done);
+            std::copy(txt.begin() + done, txt.begin() + done + n, buffer);
+            pipe.commit(n);
+            done += n;
+        }
+        pipe.finish();
+        if(digest.get() != expected){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // non contiguous input, an empty stream and finishing in the destructor
+        std::list<char> lst{'a', 'b', 'c'};
+        crypt::hash_pipeline<crypt::md5> pipe;
+        auto digest = pipe.get_future();
+        pipe.update(lst.begin(), lst.end());
+        pipe.finish();
+        if(digest.get() != crypt::md5::hash("abc")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        std::future<crypt::sha256::digest_type> empty;
+        {
+            crypt::hash_pipeline<crypt::sha256> unfinished;
+            empty = unfinished.get_future();
+        }
+        if(empty.get() != crypt::sha256::hash("")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // sizes whose rounding or product would wrap are rejected up front
+        constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
+        const std::size_t sizes[][2] = {{1, max}, {1, max - 4094}, {max / 4096 + 1, 4096},
+                                        {3, max / 3 + 1}};
+        for(const auto& s : sizes){
+            bool thrown = false;
+            try{
+                crypt::hash_pipeline<crypt::sha256> pipe{s[0], s[1]};
+            }catch(const std::length_error&){
+                thrown = true;
+            }
+            if(!thrown){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+}
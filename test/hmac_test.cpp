@@ -0,0 +1,169 @@
+/**
+ * @file   libcrypt/test/hmac_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  hmac tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <hmac.hpp>
+#include <md5.hpp>
+#include <sha1.hpp>
+#include <sha224.hpp>
+#include <sha256.hpp>
+#include <sha384.hpp>
+#include <sha512.hpp>
+
+template<typename Digest>
+static std::string hex(const Digest& digest){
+    std::stringstream str;
+    for(const auto& i : digest)
+        str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+    return str.str();
+}
+
+// RFC 2202 and RFC 4231 test cases 1, 2 and 6
+template<typename Hash>
+static bool vectors(std::size_t key_size, const char* one, const char* two, const char* six){
+    const std::string key1(key_size, '\x0b');
+    const std::string key6(131, '\xaa');
+    const std::string r1 = hex(crypt::hmac<Hash>::mac(key1, "Hi There"));
+    const std::string r2 = hex(crypt::hmac<Hash>::mac("Jefe", "what do ya want for nothing?"));
+    const std::string r6 = hex(crypt::hmac<Hash>::mac(key6, "Test Using Larger Than Block-Size Key - Hash Key First"));
+    std::cout << r1 << "\n" << one << "\n"
+              << r2 << "\n" << two << "\n"
+              << r6 << "\n" << six << "\n";
+    return r1 == one && r2 == two && r6 == six;
+}
+
+int main(){
+    {
+        if(!vectors<crypt::md5>(16,
+                                "9294727a3638bb1c13f48ef8158bfc9d",
+                                "750c783e6ab0b503eaa86e310a5db738",
+                                "bfecaf4efff90a3a668f3922fec3762d")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        if(!vectors<crypt::sha1>(20,
+                                 "b617318655057264e28bc0b6fb378c8ef146be00",
+                                 "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79",
+                                 "90d0dace1c1bdc957339307803160335bde6df2b")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        if(!vectors<crypt::sha224>(20,
+                                   "896fb1128abbdf196832107cd49df33f47b4b1169912ba4f53684b22",
+                                   "a30e01098bc6dbbf45690f3a7e9e6d0f8bbea2a39e6148008fd05e44",
+                                   "95e9a0db962095adaebe9b2d6f0dbce2d499f112f2d2b7273fa6870e")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        if(!vectors<crypt::sha256>(20,
+                                   "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7",
+                                   "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843",
+                                   "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        if(!vectors<crypt::sha384>(20,
+                                   "afd03944d84895626b0825f4ab46907f15f9dadbe4101ec682aa034c7cebc59c"
+                                   "faea9ea9076ede7f4af152e8b2fa9cb6",
+                                   "af45d2e376484031617f78d2b58a6b1b9c7ef464f5a01b47e42ec3736322445e"
+                                   "8e2240ca5e69e2c78b3239ecfab21649",
+                                   "4ece084485813e9088d2c63a041bc5b44f9ef1012a2b588f3cd11f05033ac4c6"
+                                   "0c2ef6ab4030fe8296248df163f44952")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        if(!vectors<crypt::sha512>(20,
+                                   "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+                                   "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854",
+                                   "164b7a7bfcf819e2e395fbe73b56e0a387bd64222e831fd610270cd7ea250554"
+                                   "9758bf75c05a994a6d034f65f8f0e6fdcaeab1a34d4a6b4b636e070a38bce737",
+                                   "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+                                   "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // streaming in uneven chunks, then reset() and the same message again
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+        const std::string key{"key"};
+
+        crypt::hmac<crypt::sha256> algo{key};
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        const auto first = algo.final();
+
+        algo.reset();
+        for(const auto& i : txt)
+            algo.update(i);
+        const auto second = algo.final();
+
+        const std::string message(txt.begin(), txt.end());
+        if(first != second || first != crypt::hmac<crypt::sha256>::mac(key, message)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a key of exactly one block is used as is, one byte more is hashed
+        const std::string block(64, 'k');
+        const std::string longer(65, 'k');
+        const auto digest = crypt::sha256::hash(longer);
+        crypt::hmac<crypt::sha256> hashed{digest.begin(), digest.end()};
+        hashed.update(std::string_view{"abc"}.begin(), std::string_view{"abc"}.end());
+        if(hashed.final() != crypt::hmac<crypt::sha256>::mac(longer, "abc") ||
+           crypt::hmac<crypt::sha256>::mac(block, "abc") == crypt::hmac<crypt::sha256>::mac(longer, "abc")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // computed by the compiler
+        constexpr auto mac = crypt::hmac<crypt::sha256>::mac("Jefe", "what do ya want for nothing?");
+        static_assert(mac[0] == 0x5b && mac[31] == 0x43, "crypt::hmac::mac is not constexpr");
+    }
+}
@@ -0,0 +1,195 @@
+/**
+ * @file   libcrypt/test/instrument_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  opt-in instrumentation counters
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#define LIBCRYPT_INSTRUMENT
+
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <thread>
+#include <vector>
+
+#include "instrument.hpp"
+#include "md5.hpp"
+#include "sha256.hpp"
+#include "sha512.hpp"
+
+int main(){
+    using crypt::instrument::algorithm;
+    using crypt::instrument::histogram;
+    {
+        // constant expressions skip the hooks
+        static_assert(crypt::instrument::enabled, "crypt::instrument::enabled is not set");
+        constexpr auto one = crypt::sha256::hash("abc");
+        static_assert(one[0] == 0xba && one[31] == 0xad, "crypt::sha256::hash is not constexpr");
+    }
+    {
+        // ten updates of 10 bytes: one buffered block, one padding block
+        std::vector<std::uint8_t> txt(100, 'a');
+        const auto before = crypt::instrument::collect();
+        crypt::sha256 algo;
+        for(std::size_t i = 0; i < txt.size(); i += 10)
+            algo.update(txt.begin() + static_cast<std::ptrdiff_t>(i), txt.begin() + static_cast<std::ptrdiff_t>(i + 10));
+        (void)algo.final();
+        const auto delta = crypt::instrument::collect().since(before);
+        const auto& c = delta[algorithm::sha256];
+        if(c.bytes != 100 || c.updates != 10 || c.blocks != 2 || c.finals != 1 || c.flushes != 1 ||
+           c.update_bytes.buckets[histogram::bucket(10)] != 10 || c.update_bytes.count() != 10 ||
+           delta[algorithm::md5].updates != 0 || delta[algorithm::sha512].blocks != 0){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a non-contiguous range is one update() call, every block goes through the buffer
+        std::list<char> txt(130, 'x');
+        const auto before = crypt::instrument::collect();
+        auto digest = [&txt]{
+            crypt::md5 algo;
+            algo.update(txt.begin(), txt.end());
+            algo.update('y');
+            return algo.final();
+        };
+        (void)digest();
+        const auto c = crypt::instrument::collect().since(before)[algorithm::md5];
+        if(c.bytes != 131 || c.updates != 2 || c.blocks != 3 || c.finals != 1 || c.flushes != 2 ||
+           c.update_bytes.buckets[histogram::bucket(130)] != 1 || c.update_bytes.buckets[1] != 1){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a thread started after the period is set times every update(), final() and transform() call
+        crypt::instrument::set_sample_period(1);
+        std::vector<std::uint8_t> txt(1000, 'b');
+        const auto before = crypt::instrument::collect();
+        std::thread worker([&txt]{
+            crypt::sha512 algo;
+            algo.update(txt.begin(), txt.end());
+            (void)algo.final();
+        });
+        worker.join();
+        crypt::instrument::set_sample_period(64);
+
+        // the counters of an exited thread are kept
+        const auto c = crypt::instrument::collect().since(before)[algorithm::sha512];
+        if(crypt::instrument::sample_period() != 64 || c.bytes != 1000 || c.blocks != 8 ||
+           c.sampled_transforms != 2 || c.sampled_blocks != 8 || c.sampled_cycles == 0 ||
+           c.transform_cycles.count() != 2 || c.update_cycles.count() != 1 || c.final_cycles.count() != 1){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // timing stopped and resumed on this thread picks up the new period
+        std::vector<std::uint8_t> txt(100, 'd');
+        auto digest = [&txt]{
+            crypt::sha256 algo;
+            algo.update(txt.begin(), txt.end());
+            return algo.final();
+        };
+        // enough transforms to run out the countdown of the old period
+        crypt::instrument::set_sample_period(0);
+        for(std::size_t i = 0; i < 40; i++)
+            (void)digest();
+        const auto stopped = crypt::instrument::collect();
+        (void)digest();
+        crypt::instrument::set_sample_period(1);
+        const auto resumed = crypt::instrument::collect();
+        for(std::size_t i = 0; i < 100; i++)
+            (void)digest();
+        crypt::instrument::set_sample_period(64);
+
+        const auto off = resumed.since(stopped)[algorithm::sha256];
+        const auto on = crypt::instrument::collect().since(resumed)[algorithm::sha256];
+        if(off.blocks != 2 || off.sampled_transforms != 0 ||
+           on.blocks != 200 || on.sampled_transforms != 200 ||
+           on.update_cycles.count() != 100 || on.final_cycles.count() != 100){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a thread_local destroyed after the block went back hashes uncounted, no block leaks
+        struct late{
+            ~late(){
+                crypt::sha256 algo;
+                algo.update('x');
+                (void)algo.final();
+            }
+        };
+        auto blocks = []{
+            std::size_t n = 0;
+            for(auto* t = crypt::impl::instrument_threads.load(); t != nullptr; t = t->next)
+                n++;
+            return n;
+        };
+        const auto before = crypt::instrument::collect();
+        const std::size_t listed = blocks();
+        for(std::size_t i = 0; i < 4; i++){
+            std::thread worker([]{
+                thread_local late destroyed_last;
+                crypt::sha256 algo;
+                algo.update('y');
+                (void)algo.final();
+            });
+            worker.join();
+        }
+        const auto c = crypt::instrument::collect().since(before)[algorithm::sha256];
+        if(blocks() > listed + 1 || c.finals != 4 || c.bytes != 4){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // per-thread counters add up
+        std::vector<std::uint8_t> txt(1000, 'c');
+        const auto before = crypt::instrument::collect();
+        std::vector<std::thread> workers;
+        for(std::size_t i = 0; i < 4; i++){
+            workers.emplace_back([&txt]{
+                for(std::size_t j = 0; j < 8; j++){
+                    crypt::sha256 algo;
+                    algo.update(txt.begin(), txt.end());
+                    (void)algo.final();
+                }
+            });
+        }
+        for(auto& worker : workers)
+            worker.join();
+        const auto c = crypt::instrument::collect().since(before)[algorithm::sha256];
+        if(c.bytes != 32 * 1000 || c.updates != 32 || c.finals != 32 || c.blocks != 32 * 16){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
@@ -29,10 +29,12 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <md2.hpp>
 
@@ -90,4 +92,21 @@ int main(){
             return 1;
         }
     }
+    {
+        crypt::md2 algo;
+        crypt::md2 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
 }
@@ -0,0 +1,94 @@
+/**
+ * @file   libcrypt/test/md5_mb_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  multi-buffer md5 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <md5_mb.hpp>
+
+template<typename MB>
+static bool check(const std::vector<std::string>& messages){
+    auto res = MB::hash(messages);
+    if(res.size() != messages.size())
+        return false;
+    for(std::size_t i = 0; i < messages.size(); i++){
+        crypt::md5 algo;
+        algo.update(messages[i].begin(), messages[i].end());
+        if(algo.final() != res[i])
+            return false;
+    }
+    return true;
+}
+
+template<typename MB>
+static bool check_all(const std::vector<std::string>& messages){
+    crypt::force_scalar(true);
+    bool ok = check<MB>(messages);
+    crypt::force_scalar(false);
+    return ok && check<MB>(messages);
+}
+
+int main(){
+    {
+        std::vector<std::string> txt{"abc", "", "message digest"};
+        std::string output{"0xf96b697d7cb7938d525a2f31aaf161d0"};
+
+        auto res = crypt::md5_x4::hash(txt);
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res[2])
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // uneven lengths around the padding boundaries, more messages than lanes
+        std::vector<std::string> txt;
+        for(std::size_t n = 0; n < 300; n += (n % 64 > 50) ? 1 : 7){
+            std::string m(n, '\0');
+            for(std::size_t i = 0; i < n; i++)
+                m[i] = static_cast<char>(i * 31 + n);
+            txt.push_back(m);
+        }
+
+        if(!check_all<crypt::md5_x4>(txt) ||
+           !check_all<crypt::md5_x8>(txt) ||
+           !check_all<crypt::md5_x16>(txt)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
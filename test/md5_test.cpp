@@ -29,10 +29,13 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <md5.hpp>
 
@@ -142,4 +145,107 @@ int main(){
             return 1;
         }
     }
+    {
+        crypt::md5 algo;
+        crypt::md5 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // computed by the compiler, the second message spans two blocks
+        constexpr auto one = crypt::md5::hash("abc");
+        constexpr auto two = crypt::md5::hash("12345678901234567890123456789012345678901234567890123456789012345678901234567890");
+        static_assert(one[0] == 0x90 && one[15] == 0x72, "crypt::md5::hash is not constexpr");
+        static_assert(two[0] == 0x57 && two[15] == 0x7a, "crypt::md5::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::md5::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a prefix compressed once, resumed for several suffixes
+        std::vector<std::uint8_t> prefix(3 * crypt::md5::block_size);
+        for(std::size_t i = 0; i < prefix.size(); i++)
+            prefix[i] = static_cast<std::uint8_t>(i * 13 + 5);
+
+        crypt::md5::midstate_type mid = crypt::md5().export_midstate();
+        crypt::md5::compress(mid, prefix.data(), 2);
+        crypt::md5::compress(mid, prefix.data() + 2 * crypt::md5::block_size, 1);
+
+        crypt::md5 streamed;
+        streamed.update(prefix.begin(), prefix.end());
+        if(mid != streamed.export_midstate()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        for(const std::string& suffix : {std::string(), std::string("abc"), std::string(200, 'x')}){
+            crypt::md5 resumed{mid};
+            resumed.update(suffix.begin(), suffix.end());
+
+            crypt::md5 full;
+            full.update(prefix.begin(), prefix.end());
+            full.update(suffix.begin(), suffix.end());
+            if(resumed.final() != full.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+
+        // fork in the middle of a block, export only at a boundary
+        crypt::md5 base{mid};
+        base.update(prefix.begin(), prefix.begin() + 7);
+        crypt::md5 copy = base.fork();
+        copy.update(prefix.begin(), prefix.begin() + 9);
+        base.update(prefix.begin(), prefix.begin() + 9);
+        if(base.block_aligned() || copy.final() != base.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        bool thrown = false;
+        try{
+            crypt::md5 partial{mid};
+            partial.update(prefix.begin(), prefix.begin() + 1);
+            (void)partial.export_midstate();
+        }catch(const std::logic_error&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // the rolled rounds of policy::compact give the same digests
+        constexpr auto one = crypt::basic_md5<crypt::policy::compact>::hash("abc");
+        static_assert(one[0] == 0x90 && one[15] == 0x72, "crypt::basic_md5<compact>::hash is not constexpr");
+
+        std::vector<std::uint8_t> txt(300);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 13 + 1);
+        for(std::size_t len = 0; len <= txt.size(); len += 7){
+            crypt::md5 fast;
+            crypt::basic_md5<crypt::policy::compact> compact;
+            fast.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            compact.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            if(fast.final() != compact.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
 }
@@ -0,0 +1,116 @@
+/**
+ * @file   libcrypt/test/merkle_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  merkle tree hashing tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <merkle.hpp>
+#include <sha1.hpp>
+#include <sha256.hpp>
+
+// straightforward recursive RFC 6962 tree over leaves of chunk bytes
+template<typename Hash>
+static auto reference(const std::uint8_t* first, std::size_t leaves, std::size_t len, std::size_t chunk){
+    if(leaves == 1){
+        Hash algo;
+        algo.update(std::uint8_t{0x00});
+        algo.update(first, first + len);
+        return algo.final();
+    }
+
+    std::size_t k = 1;
+    while(k * 2 < leaves)
+        k *= 2;
+    auto left = reference<Hash>(first, k, k * chunk, chunk);
+    auto right = reference<Hash>(first + k * chunk, leaves - k, len - k * chunk, chunk);
+
+    Hash algo;
+    algo.update(std::uint8_t{0x01});
+    algo.update(left.begin(), left.end());
+    algo.update(right.begin(), right.end());
+    return algo.final();
+}
+
+template<typename Hash>
+static bool check(const std::vector<std::uint8_t>& txt, std::size_t chunk, crypt::thread_pool& pool){
+    const std::size_t leaves = std::max<std::size_t>((txt.size() + chunk - 1) / chunk, 1);
+    auto expected = reference<Hash>(txt.data(), leaves, txt.size(), chunk);
+
+    if(crypt::merkle<Hash>::hash(txt.begin(), txt.end(), chunk, pool) != expected)
+        return false;
+
+    // streaming in uneven pieces
+    crypt::merkle<Hash> algo{chunk, pool};
+    for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 3 + 1)
+        algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+    return algo.final() == expected;
+}
+
+int main(){
+    {
+        // a single leaf is Hash(0x00 || data)
+        std::string txt{"abc"};
+        std::string output{"0x609f6e36d2405585188d5cfd761f407c7cc46a7d3f314c88270469dde315fcd1"};
+
+        auto res = crypt::merkle<crypt::sha256>::hash(txt.begin(), txt.end());
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::thread_pool single{1};
+        crypt::thread_pool pool{4};
+
+        for(std::size_t len : {0, 1, 63, 64, 65, 640, 1000, 4097, 20000}){
+            std::vector<std::uint8_t> txt(len);
+            for(std::size_t i = 0; i < txt.size(); i++)
+                txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+            for(std::size_t chunk : {1, 64, 100, 1024}){
+                if(!check<crypt::sha256>(txt, chunk, single) ||
+                   !check<crypt::sha256>(txt, chunk, pool) ||
+                   !check<crypt::sha1>(txt, chunk, pool)){
+                    std::cerr << "failed\n";
+                    return 1;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file   libcrypt/test/pbkdf2_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  pbkdf2 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <md5.hpp>
+#include <pbkdf2.hpp>
+#include <sha1.hpp>
+#include <sha224.hpp>
+#include <sha256.hpp>
+#include <sha512.hpp>
+
+template<typename Digest>
+static std::string hex(const Digest& digest){
+    std::stringstream str;
+    for(const auto& i : digest)
+        str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+    return str.str();
+}
+
+template<typename Hash>
+static bool check(std::string_view password, std::string_view salt, std::uint32_t iterations,
+                  std::size_t len, const std::string& output){
+    const std::string res = hex(crypt::pbkdf2<Hash>::derive(password, salt, iterations, len));
+    std::cout << res << "\n" << output << "\n";
+    return res == output;
+}
+
+int main(){
+    {
+        // RFC 6070
+        if(!check<crypt::sha1>("password", "salt", 1, 20, "0c60c80f961f0e71f3a9b524af6012062fe037a6") ||
+           !check<crypt::sha1>("password", "salt", 4096, 20, "4b007901b765489abead49d926f721d065a429c1") ||
+           !check<crypt::sha1>("passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 25,
+                               "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        if(!check<crypt::sha256>("password", "salt", 1, 32,
+                                 "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b") ||
+           !check<crypt::sha256>("password", "salt", 4096, 32,
+                                 "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a") ||
+           !check<crypt::sha256>("passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096, 40,
+                                 "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9") ||
+           !check<crypt::sha256>(std::string_view{"pass\0word", 9}, std::string_view{"sa\0lt", 5}, 4096, 16,
+                                 "89b69d0516f829893c696226650a8687")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // 128 byte blocks, the little endian md5 and 22 sha224 blocks, more than a full set of lanes
+        if(!check<crypt::sha512>("password", "salt", 2, 100,
+                                 "e1d9c16aa681708a45f5c7c4e215ceb66e011a2e9f0040713f18aefdb866d53c"
+                                 "f76cab2868a39b9f7840edce4fef5a82be67335c77a6068e04112754f27ccf4e"
+                                 "473e311ad827b68945f4e2dddb204c78e40e2495141e411cd272d020640d673c"
+                                 "d34aa29f") ||
+           !check<crypt::md5>("password", "salt", 3, 40,
+                              "f6acd4bda3e4d3d831a5f61da9ca9d5c3877566e979f4928778d81be4f2e9433a31043bbf3945c35")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+        const std::string sha224 = hex(crypt::pbkdf2<crypt::sha224>::derive("password", "salt", 1000, 600));
+        if(sha224.substr(0, 56) != "d3bcf320fd918908eafcaa460faf40e201f6508d4e6f3d9c1c0abd30" ||
+           sha224.substr(1144) != "fd16a9594addbe32408a015362bcf96907f823ca12ef45cecb265ba4"){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a batch of derivations against one at a time, with and without lanes
+        std::vector<std::string> passwords;
+        for(std::size_t i = 0; i < 37; ++i)
+            passwords.push_back("password" + std::to_string(i));
+        std::vector<std::vector<std::uint8_t>> keys(passwords.size(), std::vector<std::uint8_t>(20));
+        std::vector<crypt::pbkdf2<crypt::sha256>::request> requests;
+        for(std::size_t i = 0; i < passwords.size(); ++i)
+            requests.push_back({passwords[i], "salt", keys[i].data(), keys[i].size()});
+        crypt::pbkdf2<crypt::sha256>::derive(requests.data(), requests.size(), 100);
+
+        for(bool scalar : {false, true}){
+            crypt::force_scalar(scalar);
+            for(std::size_t i = 0; i < passwords.size(); ++i){
+                if(crypt::pbkdf2<crypt::sha256>::derive(passwords[i], "salt", 100, 20) != keys[i]){
+                    std::cerr << "failed\n";
+                    return 1;
+                }
+            }
+        }
+        crypt::force_scalar(false);
+    }
+}
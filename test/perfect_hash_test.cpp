@@ -0,0 +1,116 @@
+/**
+ * @file   libcrypt/test/perfect_hash_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  perfect hash table tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <perfect_hash.hpp>
+#include <sdbm.hpp>
+
+static constexpr auto methods = crypt::make_perfect_hash(
+    "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE", "PATCH");
+
+static_assert(methods.find("GET") == 0, "crypt::perfect_hash is not constexpr");
+static_assert(methods.find("PATCH") == 8, "crypt::perfect_hash is not constexpr");
+static_assert(methods.find("get") == methods.npos, "crypt::perfect_hash is not constexpr");
+
+static int dispatch(std::string_view method){
+    switch(methods.find(method)){
+    case 0:  return 1;
+    case 2:  return 2;
+    case 3:  return 3;
+    default: return 0;
+    }
+}
+
+template<std::size_t N, typename Hash>
+static bool check(const std::array<std::string_view, N>& keys){
+    const crypt::perfect_hash<N, Hash> table{keys};
+    for(std::size_t i = 0; i < N; i++)
+        if(table.find(keys[i]) != i)
+            return false;
+    for(std::string_view miss : {"", "x", "key", "key-", "KEY-1"})
+        if(table.find(miss) != table.npos)
+            return false;
+    return true;
+}
+
+int main(){
+    {
+        if(dispatch("GET") != 1 || dispatch("POST") != 2 || dispatch("PUT") != 3 ||
+           dispatch("HEAD") != 0 || dispatch("") != 0 || dispatch("GETS") != 0){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        constexpr auto headers = crypt::make_perfect_hash<crypt::sdbm>(
+            "accept", "accept-encoding", "authorization", "cache-control", "connection",
+            "content-length", "content-type", "cookie", "host", "if-none-match",
+            "origin", "referer", "transfer-encoding", "user-agent", "");
+        static_assert(headers.find("host") == 8, "crypt::perfect_hash is not constexpr");
+        static_assert(headers.find("") == 14, "crypt::perfect_hash is not constexpr");
+        if(headers.find("user-agent") != 13 || headers.contains("Host")){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // larger key set built at run time, both hash functions
+        std::vector<std::string> storage;
+        std::array<std::string_view, 2000> keys;
+        for(std::size_t i = 0; i < keys.size(); i++)
+            storage.push_back("key-" + std::to_string(i * 7919));
+        for(std::size_t i = 0; i < keys.size(); i++)
+            keys[i] = storage[i];
+
+        if(!check<2000, crypt::djb2>(keys) || !check<2000, crypt::sdbm>(keys)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        bool thrown = false;
+        try{
+            crypt::perfect_hash<3> table{{"a", "b", "a"}};
+        }catch(const std::invalid_argument&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+/**
+ * @file   libcrypt/test/policy_size.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  code size of one hasher and policy
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "md5.hpp"
+#include "sha1.hpp"
+#include "sha224.hpp"
+#include "sha256.hpp"
+
+/*
+ * Built once per hasher and policy by `make sizes`, e.g. with
+ * -DHASHER='crypt::basic_sha256<crypt::policy::compact>'. Only the
+ * templates instantiated here end up in the object, so its text size is
+ * what the hasher costs a binary.
+ */
+#ifndef HASHER
+#define HASHER crypt::sha256
+#endif
+
+std::array<std::uint8_t, HASHER::digest_size> digest(const std::uint8_t* data, std::size_t size){
+    HASHER algo;
+    algo.update(data, data + size);
+    return algo.final();
+}
@@ -29,14 +29,27 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <algorithm>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <sha1.hpp>
 
 int main(){
+    {
+        // the environment caps the kernels, read once on first use
+        setenv("LIBCRYPT_MAX_ISA", "scalar", 1);
+        if(crypt::max_isa() != crypt::isa::scalar || std::string{crypt::sha1::kernel()} != "scalar"){
+            std::cerr << "failed\n";
+            return 1;
+        }
+        crypt::set_max_isa(crypt::isa::sha_ni);
+    }
     {
         crypt::sha1 algo;
         std::string txt{"abc"};
@@ -142,4 +155,131 @@ int main(){
             return 1;
         }
     }
+    {
+        crypt::sha1 algo;
+        crypt::sha1 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // scalar kernel against whatever kernel the CPU selects
+        for(std::size_t n = 0; n <= txt.size(); n += 37){
+            crypt::force_scalar(true);
+            crypt::sha1 ref;
+            ref.update(txt.begin(), txt.begin() + n);
+            auto expected = ref.final();
+
+            crypt::force_scalar(false);
+            crypt::sha1 algo;
+            algo.update(txt.begin(), txt.begin() + n);
+            if(algo.final() != expected){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+    {
+        // computed by the compiler, the second message spans two blocks
+        constexpr auto one = crypt::sha1::hash("abc");
+        constexpr auto two = crypt::sha1::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+        static_assert(one[0] == 0xa9 && one[19] == 0x9d, "crypt::sha1::hash is not constexpr");
+        static_assert(two[0] == 0x84 && two[19] == 0xf1, "crypt::sha1::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::sha1::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a prefix compressed once, resumed for several suffixes
+        std::vector<std::uint8_t> prefix(3 * crypt::sha1::block_size);
+        for(std::size_t i = 0; i < prefix.size(); i++)
+            prefix[i] = static_cast<std::uint8_t>(i * 13 + 5);
+
+        crypt::sha1::midstate_type mid = crypt::sha1().export_midstate();
+        crypt::sha1::compress(mid, prefix.data(), 2);
+        crypt::sha1::compress(mid, prefix.data() + 2 * crypt::sha1::block_size, 1);
+
+        crypt::sha1 streamed;
+        streamed.update(prefix.begin(), prefix.end());
+        if(mid != streamed.export_midstate()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        for(const std::string& suffix : {std::string(), std::string("abc"), std::string(200, 'x')}){
+            crypt::sha1 resumed{mid};
+            resumed.update(suffix.begin(), suffix.end());
+
+            crypt::sha1 full;
+            full.update(prefix.begin(), prefix.end());
+            full.update(suffix.begin(), suffix.end());
+            if(resumed.final() != full.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+
+        // fork in the middle of a block, export only at a boundary
+        crypt::sha1 base{mid};
+        base.update(prefix.begin(), prefix.begin() + 7);
+        crypt::sha1 copy = base.fork();
+        copy.update(prefix.begin(), prefix.begin() + 9);
+        base.update(prefix.begin(), prefix.begin() + 9);
+        if(base.block_aligned() || copy.final() != base.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        bool thrown = false;
+        try{
+            crypt::sha1 partial{mid};
+            partial.update(prefix.begin(), prefix.begin() + 1);
+            (void)partial.export_midstate();
+        }catch(const std::logic_error&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // the rolled rounds of policy::compact give the same digests
+        constexpr auto one = crypt::basic_sha1<crypt::policy::compact>::hash("abc");
+        static_assert(one[0] == 0xa9 && one[19] == 0x9d, "crypt::basic_sha1<compact>::hash is not constexpr");
+
+        std::vector<std::uint8_t> txt(300);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 13 + 1);
+        // capped at scalar, so the rolled loop runs and not the SHA-NI kernel
+        crypt::set_max_isa(crypt::isa::scalar);
+        for(std::size_t len = 0; len <= txt.size(); len += 7){
+            crypt::sha1 fast;
+            crypt::basic_sha1<crypt::policy::compact> compact;
+            fast.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            compact.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            if(fast.final() != compact.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+        crypt::set_max_isa(crypt::isa::sha_ni);
+    }
 }
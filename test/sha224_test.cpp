@@ -29,10 +29,13 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <sha224.hpp>
 
@@ -142,4 +145,131 @@ int main(){
             return 1;
         }
     }
+    {
+        crypt::sha224 algo;
+        crypt::sha224 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // scalar kernel against whatever kernel the CPU selects
+        for(std::size_t n = 0; n <= txt.size(); n += 37){
+            crypt::force_scalar(true);
+            crypt::sha224 ref;
+            ref.update(txt.begin(), txt.begin() + n);
+            auto expected = ref.final();
+
+            crypt::force_scalar(false);
+            crypt::sha224 algo;
+            algo.update(txt.begin(), txt.begin() + n);
+            if(algo.final() != expected){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+    {
+        // computed by the compiler, the second message spans two blocks
+        constexpr auto one = crypt::sha224::hash("abc");
+        constexpr auto two = crypt::sha224::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+        static_assert(one[0] == 0x23 && one[27] == 0xa7, "crypt::sha224::hash is not constexpr");
+        static_assert(two[0] == 0x75 && two[27] == 0x25, "crypt::sha224::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::sha224::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a prefix compressed once, resumed for several suffixes
+        std::vector<std::uint8_t> prefix(3 * crypt::sha224::block_size);
+        for(std::size_t i = 0; i < prefix.size(); i++)
+            prefix[i] = static_cast<std::uint8_t>(i * 13 + 5);
+
+        crypt::sha224::midstate_type mid = crypt::sha224().export_midstate();
+        crypt::sha224::compress(mid, prefix.data(), 2);
+        crypt::sha224::compress(mid, prefix.data() + 2 * crypt::sha224::block_size, 1);
+
+        crypt::sha224 streamed;
+        streamed.update(prefix.begin(), prefix.end());
+        if(mid != streamed.export_midstate()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        for(const std::string& suffix : {std::string(), std::string("abc"), std::string(200, 'x')}){
+            crypt::sha224 resumed{mid};
+            resumed.update(suffix.begin(), suffix.end());
+
+            crypt::sha224 full;
+            full.update(prefix.begin(), prefix.end());
+            full.update(suffix.begin(), suffix.end());
+            if(resumed.final() != full.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+
+        // fork in the middle of a block, export only at a boundary
+        crypt::sha224 base{mid};
+        base.update(prefix.begin(), prefix.begin() + 7);
+        crypt::sha224 copy = base.fork();
+        copy.update(prefix.begin(), prefix.begin() + 9);
+        base.update(prefix.begin(), prefix.begin() + 9);
+        if(base.block_aligned() || copy.final() != base.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        bool thrown = false;
+        try{
+            crypt::sha224 partial{mid};
+            partial.update(prefix.begin(), prefix.begin() + 1);
+            (void)partial.export_midstate();
+        }catch(const std::logic_error&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // the rolled rounds of policy::compact give the same digests
+        constexpr auto one = crypt::basic_sha224<crypt::policy::compact>::hash("abc");
+        static_assert(one[0] == 0x23 && one[27] == 0xa7, "crypt::basic_sha224<compact>::hash is not constexpr");
+
+        std::vector<std::uint8_t> txt(300);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 13 + 1);
+        // capped at scalar, so the rolled loop runs and not the SHA-NI kernel
+        crypt::set_max_isa(crypt::isa::scalar);
+        for(std::size_t len = 0; len <= txt.size(); len += 7){
+            crypt::sha224 fast;
+            crypt::basic_sha224<crypt::policy::compact> compact;
+            fast.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            compact.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            if(fast.final() != compact.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+        crypt::set_max_isa(crypt::isa::sha_ni);
+    }
 }
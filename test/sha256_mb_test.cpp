@@ -0,0 +1,132 @@
+/**
+ * @file   libcrypt/test/sha256_mb_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  multi-buffer sha256 and sha224 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sha256_mb.hpp>
+
+template<typename MB, typename Hash>
+static bool check(const std::vector<std::string>& messages){
+    auto res = MB::hash(messages);
+    if(res.size() != messages.size())
+        return false;
+    for(std::size_t i = 0; i < messages.size(); i++){
+        Hash algo;
+        algo.update(messages[i].begin(), messages[i].end());
+        if(algo.final() != res[i])
+            return false;
+    }
+    return true;
+}
+
+template<typename MB, typename Hash>
+static bool check_all(const std::vector<std::string>& messages){
+    crypt::force_scalar(true);
+    bool ok = check<MB, Hash>(messages);
+    crypt::force_scalar(false);
+    return ok && check<MB, Hash>(messages);
+}
+
+#if defined(LIBCRYPT_X86_KERNELS)
+// run a lane kernel directly, the public API may prefer another kernel
+template<typename Kernel, typename Hash>
+static bool check_kernel(const std::vector<std::string>& messages){
+    std::vector<const std::uint8_t*> pointers;
+    std::vector<std::size_t> lengths;
+    for(const auto& i : messages){
+        pointers.push_back(reinterpret_cast<const std::uint8_t*>(i.data()));
+        lengths.push_back(i.size());
+    }
+
+    std::vector<decltype(Hash{}.final())> res(messages.size());
+    crypt::impl::mb::run<Kernel>(pointers.data(), lengths.data(), messages.size(), res.data());
+    for(std::size_t i = 0; i < messages.size(); i++){
+        Hash algo;
+        algo.update(messages[i].begin(), messages[i].end());
+        if(algo.final() != res[i])
+            return false;
+    }
+    return true;
+}
+#endif
+
+int main(){
+    {
+        std::vector<std::string> txt{"abc", "", "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"};
+        std::string output{"0x248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"};
+
+        auto res = crypt::sha256_x8::hash(txt);
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res[2])
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // uneven lengths around the padding boundaries, more messages than lanes
+        std::vector<std::string> txt;
+        for(std::size_t n = 0; n < 300; n += (n % 64 > 50) ? 1 : 7){
+            std::string m(n, '\0');
+            for(std::size_t i = 0; i < n; i++)
+                m[i] = static_cast<char>(i * 31 + n);
+            txt.push_back(m);
+        }
+
+        if(!check_all<crypt::sha256_x8,  crypt::sha256>(txt) ||
+           !check_all<crypt::sha256_x16, crypt::sha256>(txt) ||
+           !check_all<crypt::sha224_x8,  crypt::sha224>(txt) ||
+           !check_all<crypt::sha224_x16, crypt::sha224>(txt)){
+            std::cerr << "failed\n";
+            return 1;
+        }
+#if defined(LIBCRYPT_X86_KERNELS)
+        if(crypt::impl::cpu::features().avx2 &&
+           (!check_kernel<crypt::impl::sha256_avx2<crypt::sha256>, crypt::sha256>(txt) ||
+            !check_kernel<crypt::impl::sha256_avx2<crypt::sha224>, crypt::sha224>(txt))){
+            std::cerr << "failed\n";
+            return 1;
+        }
+        if(crypt::impl::cpu::features().avx512f &&
+           (!check_kernel<crypt::impl::sha256_avx512<crypt::sha256>, crypt::sha256>(txt) ||
+            !check_kernel<crypt::impl::sha256_avx512<crypt::sha224>, crypt::sha224>(txt))){
+            std::cerr << "failed\n";
+            return 1;
+        }
+#endif
+    }
+}
@@ -29,13 +29,42 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  */
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <sha256.hpp>
 
+#if defined(LIBCRYPT_X86_KERNELS)
+// digest of a message through one transform kernel, padding done by hand
+template<typename Kernel>
+static std::array<std::uint8_t, 32> kernel_digest(Kernel kernel, std::vector<std::uint8_t> msg){
+    const std::uint64_t bitlen = msg.size() * 8;
+    msg.push_back(0x80);
+    while(msg.size() % 64 != 56)
+        msg.push_back(0x00);
+    for(int i = 7; i >= 0; --i)
+        msg.push_back(static_cast<std::uint8_t>(bitlen >> (i * 8)));
+
+    std::uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                              0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    kernel(state, crypt::impl::sha256_k.data(), msg.data(), msg.size() / 64);
+
+    std::array<std::uint8_t, 32> res;
+    for(std::size_t i = 0; i < 32; ++i)
+        res[i] = static_cast<std::uint8_t>(state[i / 4] >> (24 - (i % 4) * 8));
+    return res;
+}
+#endif
+
 int main(){
     {
         crypt::sha256 algo;
@@ -142,4 +171,195 @@ int main(){
             return 1;
         }
     }
+    {
+        crypt::sha256 algo;
+        crypt::sha256 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // scalar kernel against whatever kernel the CPU selects
+        for(std::size_t n = 0; n <= txt.size(); n += 37){
+            crypt::force_scalar(true);
+            crypt::sha256 ref;
+            ref.update(txt.begin(), txt.begin() + n);
+            auto expected = ref.final();
+
+            crypt::force_scalar(false);
+            crypt::sha256 algo;
+            algo.update(txt.begin(), txt.begin() + n);
+            if(algo.final() != expected){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+    {
+        // computed by the compiler, the second message spans two blocks
+        constexpr auto one = crypt::sha256::hash("abc");
+        constexpr auto two = crypt::sha256::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+        static_assert(one[0] == 0xba && one[31] == 0xad, "crypt::sha256::hash is not constexpr");
+        static_assert(two[0] == 0x24 && two[31] == 0xc1, "crypt::sha256::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::sha256::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a prefix compressed once, resumed for several suffixes
+        static_assert(std::is_trivially_copyable_v<crypt::sha256::midstate_type>,
+                      "crypt::midstate must be trivially copyable");
+        std::vector<std::uint8_t> prefix(3 * crypt::sha256::block_size);
+        for(std::size_t i = 0; i < prefix.size(); i++)
+            prefix[i] = static_cast<std::uint8_t>(i * 13 + 5);
+
+        crypt::sha256::midstate_type mid = crypt::sha256().export_midstate();
+        crypt::sha256::compress(mid, prefix.data(), 2);
+        crypt::sha256::compress(mid, prefix.data() + 2 * crypt::sha256::block_size, 1);
+
+        crypt::sha256 streamed;
+        streamed.update(prefix.begin(), prefix.end());
+        if(mid != streamed.export_midstate()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        for(const std::string& suffix : {std::string(), std::string("abc"), std::string(200, 'x')}){
+            crypt::sha256 resumed{mid};
+            resumed.update(suffix.begin(), suffix.end());
+
+            crypt::sha256 full;
+            full.update(prefix.begin(), prefix.end());
+            full.update(suffix.begin(), suffix.end());
+            if(resumed.final() != full.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+
+        // fork in the middle of a block, export only at a boundary
+        crypt::sha256 base{mid};
+        base.update(prefix.begin(), prefix.begin() + 7);
+        crypt::sha256 copy = base.fork();
+        copy.update(prefix.begin(), prefix.begin() + 9);
+        base.update(prefix.begin(), prefix.begin() + 9);
+        if(base.block_aligned() || copy.final() != base.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        bool thrown = false;
+        try{
+            crypt::sha256 partial{mid};
+            partial.update(prefix.begin(), prefix.begin() + 1);
+            (void)partial.export_midstate();
+        }catch(const std::logic_error&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+#if defined(LIBCRYPT_X86_KERNELS)
+    {
+        // every SIMD kernel the CPU has against the scalar one, odd and
+        // even block counts for the two block AVX2 kernel
+        const auto& cpu = crypt::impl::cpu::features();
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 29 + 3);
+
+        for(std::size_t n = 0; n <= txt.size(); n += 41){
+            std::vector<std::uint8_t> msg(txt.begin(), txt.begin() + n);
+            crypt::force_scalar(true);
+            crypt::sha256 ref;
+            ref.update(msg.begin(), msg.end());
+            auto expected = ref.final();
+            crypt::force_scalar(false);
+
+            if((cpu.ssse3 && kernel_digest(crypt::impl::sha256_transform_ssse3, msg) != expected) ||
+               (cpu.avx2 && cpu.bmi2 && kernel_digest(crypt::impl::sha256_transform_avx2, msg) != expected) ||
+               (cpu.sha && cpu.sse41 && kernel_digest(crypt::impl::sha256_transform_shani, msg) != expected)){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+    }
+#endif
+    {
+        // the cap selects the kernel, every kernel gives the same digest
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 29 + 3);
+        auto digest = [&txt]{
+            crypt::sha256 algo;
+            algo.update(txt.begin(), txt.end());
+            return algo.final();
+        };
+        const auto expected = digest();
+
+        const std::pair<crypt::isa, const char*> caps[] = {
+            {crypt::isa::sha_ni, nullptr}, {crypt::isa::avx512, nullptr}, {crypt::isa::avx2, nullptr},
+            {crypt::isa::ssse3, nullptr}, {crypt::isa::sse2, "scalar"}, {crypt::isa::scalar, "scalar"}
+        };
+        for(const auto& [cap, name] : caps){
+            crypt::set_max_isa(cap);
+            const std::string kernel = crypt::sha256::kernel();
+            if(crypt::max_isa() != cap || (name != nullptr && kernel != name) ||
+               (cap < crypt::isa::sha_ni && kernel == "sha-ni") ||
+               (cap < crypt::isa::avx2 && kernel == "avx2") ||
+               digest() != expected){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+        crypt::set_max_isa(crypt::isa::sha_ni);
+    }
+    {
+        // the rolled rounds of policy::compact give the same digests
+        constexpr auto one = crypt::basic_sha256<crypt::policy::compact>::hash("abc");
+        static_assert(one[0] == 0xba && one[31] == 0xad, "crypt::basic_sha256<compact>::hash is not constexpr");
+
+        std::vector<std::uint8_t> txt(300);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 13 + 1);
+        // capped at scalar, so the rolled loop runs and not the SHA-NI kernel
+        crypt::set_max_isa(crypt::isa::scalar);
+        for(std::size_t len = 0; len <= txt.size(); len += 7){
+            crypt::sha256 fast;
+            crypt::basic_sha256<crypt::policy::compact> compact;
+            fast.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            compact.update(txt.begin(), txt.begin() + static_cast<std::ptrdiff_t>(len));
+            if(fast.final() != compact.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+        crypt::set_max_isa(crypt::isa::sha_ni);
+
+        // no unrolled SIMD schedule in the compact table
+        const std::string kernel = crypt::basic_sha256<crypt::policy::compact>::kernel();
+        if(kernel != "sha-ni" && kernel != "scalar"){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
 }
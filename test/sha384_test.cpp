@@ -0,0 +1,139 @@
+/**
+ * @file   libcrypt/test/sha384_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  sha384 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sha384.hpp>
+
+int main(){
+    {
+        crypt::sha384 algo;
+        std::string txt{"abc"};
+        std::string output{"0xcb00753f45a35e8bb5a03d699ac65007272c32ab0eded1631a8b605a43ff5bed8086072ba1e7cc2358baeca134c825a7"};
+
+        algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha384 algo;
+        //std::string txt{""};
+        std::string output{"0x38b060a751ac96384cd9327eb1b1e36a21fdb71114be07434c0cc7bf63f6e1da274edebfe76f65fbd51ad2f14898b95b"};
+
+        //algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha384 algo;
+        std::string txt{"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                        "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"};
+        std::string output{"0x09330c33f71147e83d192fc782cd1b4753111b173b3b05d22fa08086e3b0f712fcc7c71a557e2db966c3e9fa91746039"};
+
+        algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha384 algo;
+        std::string txt{"a"};
+        std::string output{"0x9d0e1809716474cb086e834e310a4a1ced149e9c00f248527972cec5704c2a5b07b8b3dc38ecc4ebae97ddd87f3d8985"};
+
+        for(std::size_t i = 0; i < 1000000; i++)
+            algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha384 algo;
+        crypt::sha384 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // computed by the compiler
+        constexpr auto one = crypt::sha384::hash("abc");
+        static_assert(one[0] == 0xcb && one[47] == 0xa7, "crypt::sha384::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::sha384::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file   libcrypt/test/sha512_256_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  sha512/256 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sha512_256.hpp>
+
+int main(){
+    {
+        crypt::sha512_256 algo;
+        std::string txt{"abc"};
+        std::string output{"0x53048e2681941ef99b2e29b76b4c7dabe4c2d0c634fc6d46e0e2f13107e7af23"};
+
+        algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512_256 algo;
+        //std::string txt{""};
+        std::string output{"0xc672b8d1ef56ed28ab87c3622c5114069bdd3ad7b8f9737498d0c01ecef0967a"};
+
+        //algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512_256 algo;
+        std::string txt{"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                        "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"};
+        std::string output{"0x3928e184fb8690f840da3988121d31be65cb9d3ef83ee6146feac861e19b563a"};
+
+        algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512_256 algo;
+        std::string txt{"a"};
+        std::string output{"0x9a59a052930187a97038cae692f30708aa6491923ef5194394dc68d56c74fb21"};
+
+        for(std::size_t i = 0; i < 1000000; i++)
+            algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512_256 algo;
+        crypt::sha512_256 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // computed by the compiler
+        constexpr auto one = crypt::sha512_256::hash("abc");
+        static_assert(one[0] == 0x53 && one[31] == 0x23, "crypt::sha512_256::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::sha512_256::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}
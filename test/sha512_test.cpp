@@ -0,0 +1,194 @@
+/**
+ * @file   libcrypt/test/sha512_test.cpp
+ * @author Peter Züger
+ * @date   18.10.2026
+ * @brief  sha512 tests
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 Peter Züger
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use, copy,
+ * modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS
+ * BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN
+ * ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sha512.hpp>
+
+int main(){
+    {
+        crypt::sha512 algo;
+        std::string txt{"abc"};
+        std::string output{"0xddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f"};
+
+        algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512 algo;
+        //std::string txt{""};
+        std::string output{"0xcf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce47d0d13c5d85f2b0ff8318d2877eec2f63b931bd47417a81a538327af927da3e"};
+
+        //algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512 algo;
+        std::string txt{"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                        "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"};
+        std::string output{"0x8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909"};
+
+        algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512 algo;
+        std::string txt{"a"};
+        std::string output{"0xe718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973ebde0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b"};
+
+        for(std::size_t i = 0; i < 1000000; i++)
+            algo.update(txt.begin(), txt.end());
+        auto res = algo.final();
+        std::stringstream str;
+        str << "0x";
+        for(const auto& i : res)
+            str << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(i);
+        std::cout << str.str() << "\n" << output << "\n";
+        if(str.str() != output){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        crypt::sha512 algo;
+        crypt::sha512 ref;
+        std::vector<std::uint8_t> txt(1000);
+        for(std::size_t i = 0; i < txt.size(); i++)
+            txt[i] = static_cast<std::uint8_t>(i * 31 + 7);
+
+        // uneven chunks through the contiguous path against single bytes
+        for(std::size_t i = 0, n = 1; i < txt.size(); i += n, n = n * 2 + 1)
+            algo.update(txt.begin() + i, txt.begin() + std::min(txt.size(), i + n));
+        for(const auto& i : txt)
+            ref.update(i);
+        if(algo.final() != ref.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // computed by the compiler
+        constexpr auto one = crypt::sha512::hash("abc");
+        static_assert(one[0] == 0xdd && one[63] == 0x9f, "crypt::sha512::hash is not constexpr");
+
+        std::string txt{"abc"};
+        if(crypt::sha512::hash(txt) != one){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+    {
+        // a prefix compressed once, resumed for several suffixes
+        std::vector<std::uint8_t> prefix(3 * crypt::sha512::block_size);
+        for(std::size_t i = 0; i < prefix.size(); i++)
+            prefix[i] = static_cast<std::uint8_t>(i * 13 + 5);
+
+        crypt::sha512::midstate_type mid = crypt::sha512().export_midstate();
+        crypt::sha512::compress(mid, prefix.data(), 2);
+        crypt::sha512::compress(mid, prefix.data() + 2 * crypt::sha512::block_size, 1);
+
+        crypt::sha512 streamed;
+        streamed.update(prefix.begin(), prefix.end());
+        if(mid != streamed.export_midstate()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        for(const std::string& suffix : {std::string(), std::string("abc"), std::string(200, 'x')}){
+            crypt::sha512 resumed{mid};
+            resumed.update(suffix.begin(), suffix.end());
+
+            crypt::sha512 full;
+            full.update(prefix.begin(), prefix.end());
+            full.update(suffix.begin(), suffix.end());
+            if(resumed.final() != full.final()){
+                std::cerr << "failed\n";
+                return 1;
+            }
+        }
+
+        // fork in the middle of a block, export only at a boundary
+        crypt::sha512 base{mid};
+        base.update(prefix.begin(), prefix.begin() + 7);
+        crypt::sha512 copy = base.fork();
+        copy.update(prefix.begin(), prefix.begin() + 9);
+        base.update(prefix.begin(), prefix.begin() + 9);
+        if(base.block_aligned() || copy.final() != base.final()){
+            std::cerr << "failed\n";
+            return 1;
+        }
+
+        bool thrown = false;
+        try{
+            crypt::sha512 partial{mid};
+            partial.update(prefix.begin(), prefix.begin() + 1);
+            (void)partial.export_midstate();
+        }catch(const std::logic_error&){
+            thrown = true;
+        }
+        if(!thrown){
+            std::cerr << "failed\n";
+            return 1;
+        }
+    }
+}